@@ -10,6 +10,9 @@
 #define VULKAN_START_BASEDEFINE_H
 
 #include <tuple>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 /*************************************************** type define ***************************************************/
 struct Size {
@@ -17,11 +20,50 @@ struct Size {
     int32_t height = 0;
 };
 
+// 呈现模式, 交换链图像数和帧节奏的组合
+enum class LatencyMode {
+    eThroughput,                                                // MAILBOX 优先, 多一张交换链图像, 主线程领先渲染线程一帧
+    eLowLatency,                                                // FIFO, 最少的图像; 上一帧显示后按预测的工作时长推迟下一帧开始
+    eImmediate,                                                 // IMMEDIATE 优先, 允许撕裂, 最少的图像
+};
+
+struct RenderSettings {
+    uint32_t framesInFlight = 2;                                // CPU 最多领先 GPU 录制的帧数
+    bool headless = false;                                      // 不创建窗口和 surface, 渲染到离屏图像
+    uint32_t frameCount = 0;                                    // 渲染指定帧数后退出, 0 表示直到窗口关闭
+    std::string captureFile;                                    // 退出前把最后一帧读回并保存为 PNG
+    uint32_t gpuProfileInterval = 0;                            // 每隔多少帧通过 Log 输出 GPU 分析报告, 0 表示不输出
+    uint32_t memoryReportInterval = 0;                          // 每隔多少帧输出各内存堆的预算和用量, 0 表示不输出
+    uint32_t defragmentInterval = 600;                          // 每隔多少帧开始一轮增量碎片整理, 0 表示不整理
+    std::string benchmarkFile;                                  // 非空时进入基准模式, 统计结果以 JSON 写入该文件
+    uint32_t warmupFrames = 100;                                // 基准模式下不计入统计的预热帧数
+    uint32_t jobThreads = 0;                                    // 任务系统的工作线程数 (命令录制, 管线编译, 纹理解码共用), 0 表示按 CPU 核数选择
+    bool gpuCulling = false;                                    // 计算着色器剔除 + 间接绘制; 关闭时由 CPU 逐对象剔除, 作为参考实现
+    bool verifyCulling = false;                                 // 每帧读回 GPU 剔除的可见数量, 与 CPU 参考结果比较
+    bool asyncCompute = false;                                  // GPU 剔除在独立计算队列上执行, 与图形队列重叠; 设备没有独立计算队列族时忽略
+    uint32_t sceneInstances = 0;                                // 压力测试场景的实例数, 0 表示只绘制默认三角形
+    uint32_t sceneMeshes = 1;                                   // 压力测试场景的网格数
+    bool instancedSubmission = true;                            // 每个网格一次实例化绘制; 关闭时每个实例一次绘制
+    bool shaderHotReload = false;                               // 监视着色器源码, 修改后在后台编译并在帧边界换入新管线
+    bool pipelineLibrary = true;                                // 设备支持图形管线库时先快速链接过渡管线, 后台再做链接期优化
+    std::vector<std::string> textureFiles;                      // 启动时流式加载的纹理
+    uint32_t textureBudgetMB = 16;                              // 每帧纹理上传的字节预算 (MB)
+    LatencyMode latencyMode = LatencyMode::eThroughput;
+    uint32_t frameRateCap = 0;                                  // 最高帧率, 主线程休眠而不是自旋; 0 表示不限制
+};
+
 
 
 /*************************************************** constant variable **********************************************/
 const Size WINDOW_SIZE = {1000, 800};
 constexpr const char *APP_NAME = "vulkan_demo";
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+constexpr const char *PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+constexpr const char *SHADER_SOURCE_DIR = "../Runtime/Shader";  // 与 .spv 一样相对于运行目录
+constexpr const char *ASSET_PACK_FILE = "../assets.pak";          // shader.bat 调用 AssetPacker 生成, 不存在时读取散落的 .spv
+constexpr uint32_t BENCHMARK_DEFAULT_FRAMES = 1000;
+constexpr uint32_t MAX_JOB_THREADS = 15;
+constexpr uint32_t JOB_IO_THREADS = 2;                          // 文件读取可能阻塞, 在固定的 I/O 线程上执行; 开启着色器热重载时另加一个给监视任务
 
 
 /*************************************************** vulkan defind **************************************************/
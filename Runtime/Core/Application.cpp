@@ -7,26 +7,247 @@
 ********************************************************************************/
 
 #include "Application.h"
+#include <string_view>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <thread>
 #include <GLFW/glfw3.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
 #include "../BaseDefine.h"
 #include "Window.h"
 #include "VkContext.h"
+#include "Benchmark.h"
+#include "FramePacer.h"
+#include "Foundation/Log.h"
+#include "Foundation/JobSystem.h"
 
-Application::Application() {
-    m_window = std::make_shared<Window>(WINDOW_SIZE);
-    m_vkContent = std::make_shared<VkContext>(m_window);
+Application::Application(const RenderSettings &settings): m_settings(settings) {
+    if(!m_settings.benchmarkFile.empty()) {
+        if(m_settings.frameCount == 0) {
+            m_settings.frameCount = BENCHMARK_DEFAULT_FRAMES;
+        }
+        m_benchmark = std::make_unique<Benchmark>(m_settings.warmupFrames, m_settings.frameCount);
+    }
+
+    // headless 模式下不初始化 GLFW, 可以运行在没有显示器的机器上
+    if(!m_settings.headless) {
+        m_window = std::make_shared<Window>(WINDOW_SIZE);
+    }
+    else if(m_settings.frameCount == 0) {
+        m_settings.frameCount = 1;
+    }
+
+    // 至少一个工作线程, 否则低优先级任务没有线程执行
+    auto jobThreads = m_settings.jobThreads;
+    if(jobThreads == 0) {
+        jobThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    // 着色器热重载的监视任务几乎一直占着一个 I/O 线程, 为它多开一个, 资源和纹理读取仍有 JOB_IO_THREADS 个线程
+    const auto ioThreads = JOB_IO_THREADS + (m_settings.shaderHotReload ? 1u : 0u);
+    m_jobSystem = std::make_unique<JobSystem>(std::clamp(jobThreads, 1u, MAX_JOB_THREADS), ioThreads);
+    m_vkContent = std::make_shared<VkContext>(m_window, *m_jobSystem, m_settings);
+    m_framePacer = std::make_unique<FramePacer>(m_settings.latencyMode == LatencyMode::eLowLatency, m_settings.frameRateCap);
 }
 
 Application::~Application() {
 
 }
 
-void Application::run() {
-    while (!glfwWindowShouldClose(m_window->GetHandle())) {
-        glfwPollEvents();
-        m_vkContent->DrawFrame();
+/**
+ * 主线程处理事件并准备快照, 渲染线程提交; GLFW 的调用都留在主线程.
+ * 处理输入前由帧节奏控制等待, 低延迟模式下输入尽量晚地进入快照
+ */
+int Application::run() {
+    std::thread renderThread(&Application::renderLoop, this);
+    for(uint64_t frame = 0; !m_framesComplete; frame++) {
+        if(!m_settings.headless) {
+            if(glfwWindowShouldClose(m_window->GetHandle())) break;
+            // 最小化时交换链无法重建, 阻塞等待事件而不是空转; 渲染线程没有新快照, 随之休眠
+            if(m_window->IsMinimized()) {
+                glfwWaitEvents();
+                continue;
+            }
+        }
+        const auto inputTime = m_framePacer->WaitForFrameStart();
+        if(!m_settings.headless) {
+            glfwPollEvents();
+        }
+        this->buildRenderPacket(m_renderPackets.GetWriteSlot(), frame, inputTime);
+        if(!m_renderPackets.Publish()) break;
     }
+    // 已发布的最后一个快照仍会被提交
+    m_renderPackets.Close();
+    renderThread.join();
     m_vkContent->WaitIdle();
+
+    if(m_benchmark != nullptr) {
+        const auto extent = m_vkContent->GetFrameExtent();
+        const Size size = { static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height) };
+        m_benchmark->WriteReport(m_settings.benchmarkFile, m_settings, m_vkContent->GetDeviceName(), size);
+    }
+
+    if(!m_settings.captureFile.empty()) {
+        this->captureFrame(m_settings.captureFile);
+    }
+
+    // 校验模式用于检查正确性, 有不一致的帧时以非零状态退出
+    const auto mismatchedFrames = m_vkContent->FinishCullingVerification();
+    Log::ErrorIf(mismatchedFrames > 0, "[Culling] {} frames did not match the CPU reference", mismatchedFrames);
+    return mismatchedFrames > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * 基准模式下每帧的耗时按渲染线程相邻两帧的间隔计算, 包含等待主线程快照的时间.
+ * 每个取到的快照都要通知帧节奏控制, 否则低延迟模式下主线程会一直等待
+ */
+void Application::renderLoop() {
+    auto frameStart = std::chrono::steady_clock::now();
+    uint64_t renderedFrames = 0;
+    while(const auto *packet = m_renderPackets.Acquire()) {
+        // 主线程得知帧数已满前可能已经多发布了一个快照
+        if(m_framesComplete) {
+            m_framePacer->OnFrameFinished({});
+            continue;
+        }
+        m_vkContent->DrawFrame(*packet);
+        m_framePacer->OnFrameFinished(m_vkContent->GetLastFrameTimings());
+        if(m_vkContent->GetLastFrameTimings().rendered) {
+            renderedFrames++;
+        }
+
+        const auto frameEnd = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> elapsed = frameEnd - frameStart;
+        frameStart = frameEnd;
+        if(m_benchmark != nullptr) {
+            m_benchmark->AddFrame(elapsed.count(), m_vkContent->GetLastFrameTimings());
+        }
+        m_framesComplete = this->isFinished(renderedFrames);
+    }
 }
 
+void Application::buildRenderPacket(RenderPacket &packet, uint64_t frame, std::chrono::steady_clock::time_point inputTime) {
+    packet.frame = frame;
+    packet.inputTime = inputTime;
+    packet.resized = false;
+    if(m_window != nullptr) {
+        packet.framebufferSize = m_window->GetFrameBufferSize();
+        packet.resized = m_window->IsResized();
+        m_window->ResetResized();
+    }
+    packet.viewProjection = glm::mat4(1.0f);
+}
+
+/**
+ * 按实际提交的帧数判断, 最小化或交换链过期时跳过的帧不算; 基准模式下还要加上预热帧
+ * @param renderedFrames 渲染线程已提交的帧数
+ * @return
+ */
+bool Application::isFinished(uint64_t renderedFrames) const {
+    if(m_benchmark != nullptr) {
+        return m_benchmark->IsComplete();
+    }
+    return m_settings.frameCount != 0 && renderedFrames >= m_settings.frameCount;
+}
 
+void Application::captureFrame(const std::string &fileName) {
+    const auto pixels = m_vkContent->ReadbackFrame();
+    if(pixels.empty()) {
+        Log::Warning("Frame capture is only available in headless mode.");
+        return;
+    }
+
+    const auto extent = m_vkContent->GetFrameExtent();
+    const auto width = static_cast<int>(extent.width);
+    const auto height = static_cast<int>(extent.height);
+    const auto result = stbi_write_png(fileName.c_str(), width, height, 4, pixels.data(), width * 4);
+    Log::ErrorIf(result == 0, "Failed to write frame capture {}!", fileName);
+    Log::InfoIf(result != 0, "Frame captured to {}", fileName);
+}
+
+RenderSettings Application::ParseCommandLine(int argc, char **argv) {
+    RenderSettings settings;
+    for(auto i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+        if(arg == "--frames-in-flight" && hasValue) {
+            settings.framesInFlight = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--headless") {
+            settings.headless = true;
+        }
+        else if(arg == "--frames" && hasValue) {
+            settings.frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--capture" && hasValue) {
+            settings.captureFile = argv[++i];
+        }
+        else if(arg == "--gpu-profile" && hasValue) {
+            settings.gpuProfileInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--memory-report" && hasValue) {
+            settings.memoryReportInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--defragment" && hasValue) {
+            settings.defragmentInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--benchmark" && hasValue) {
+            settings.benchmarkFile = argv[++i];
+        }
+        else if(arg == "--warmup" && hasValue) {
+            settings.warmupFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--job-threads" && hasValue) {
+            settings.jobThreads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--gpu-culling") {
+            settings.gpuCulling = true;
+        }
+        else if(arg == "--instances" && hasValue) {
+            settings.sceneInstances = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--meshes" && hasValue) {
+            settings.sceneMeshes = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--non-instanced") {
+            settings.instancedSubmission = false;
+        }
+        else if(arg == "--shader-hot-reload") {
+            settings.shaderHotReload = true;
+        }
+        else if(arg == "--no-pipeline-library") {
+            settings.pipelineLibrary = false;
+        }
+        else if(arg == "--texture" && hasValue) {
+            settings.textureFiles.emplace_back(argv[++i]);
+        }
+        else if(arg == "--texture-budget" && hasValue) {
+            settings.textureBudgetMB = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--async-compute") {
+            settings.gpuCulling = true;
+            settings.asyncCompute = true;
+        }
+        else if(arg == "--latency" && hasValue) {
+            const std::string_view mode = argv[++i];
+            if(mode == "low") {
+                settings.latencyMode = LatencyMode::eLowLatency;
+            }
+            else if(mode == "immediate") {
+                settings.latencyMode = LatencyMode::eImmediate;
+            }
+            else {
+                settings.latencyMode = LatencyMode::eThroughput;
+            }
+        }
+        else if(arg == "--fps-cap" && hasValue) {
+            settings.frameRateCap = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if(arg == "--verify-culling") {
+            settings.gpuCulling = true;
+            settings.verifyCulling = true;
+        }
+    }
+    return settings;
+}
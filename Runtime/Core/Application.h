@@ -9,20 +9,45 @@
 #ifndef VULKAN_START_APPLICATION_H
 #define VULKAN_START_APPLICATION_H
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
+#include "../BaseDefine.h"
+#include "RenderPacket.h"
+#include "Foundation/TripleBuffer.h"
 
 class Window;
 class VkContext;
+class Benchmark;
+class JobSystem;
+class FramePacer;
 
 class Application {
 public:
-    Application();
+    explicit Application(const RenderSettings &settings = {});
     ~Application();
-    void run();
+    // 返回进程的退出码
+    int run();
+    static RenderSettings ParseCommandLine(int argc, char **argv);
 
 private:
+    void renderLoop();
+    void buildRenderPacket(RenderPacket &packet, uint64_t frame, std::chrono::steady_clock::time_point inputTime);
+    void captureFrame(const std::string &fileName);
+    [[nodiscard]] bool isFinished(uint64_t renderedFrames) const;
+
+private:
+    RenderSettings m_settings;
+    std::unique_ptr<JobSystem> m_jobSystem;                     // 比 m_vkContent 后销毁, 其中的子系统析构时还要等待自己的任务
     std::shared_ptr<VkContext> m_vkContent = nullptr;
     std::shared_ptr<Window> m_window = nullptr;
+    std::unique_ptr<Benchmark> m_benchmark;                     // 只由渲染线程更新, 主线程通过 m_framesComplete 得知结束
+    std::unique_ptr<FramePacer> m_framePacer;                   // 主线程据此决定何时处理输入, 渲染线程每帧结束时通知它
+
+    // 主线程准备第 N+1 帧的快照时渲染线程提交第 N 帧, 主线程最多领先一帧
+    TripleBuffer<RenderPacket> m_renderPackets;
+    std::atomic<bool> m_framesComplete = false;                 // 渲染线程提交的帧数达到 --frames 后置位
 };
 
 
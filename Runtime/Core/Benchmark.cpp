@@ -0,0 +1,108 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 15:00
+* @version: 1.0
+* @description: 基准模式: 丢弃预热帧后逐帧记录各阶段耗时, 结束时输出 min/mean/p50/p95/p99 的 JSON 报告
+********************************************************************************/
+
+#include "Benchmark.h"
+#include <fstream>
+#include <iterator>
+#include <magic_enum.hpp>
+#include "VkContext.h"
+#include "Foundation/Log.h"
+#include "Foundation/Statistics.h"
+
+constexpr const char *METRIC_NAMES[] = { "cpuFrameMs", "fenceWaitMs", "acquireMs", "recordMs", "submitMs", "presentMs", "inputToPresentMs" };
+
+// 设备名等字符串写入 JSON 前转义
+static std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    for(const auto c : text) {
+        if(c == '"' || c == '\\') {
+            escaped.push_back('\\');
+        }
+        if(static_cast<unsigned char>(c) >= 0x20) {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+Benchmark::Benchmark(uint32_t warmupFrames, uint32_t measuredFrames): m_warmupFrames(warmupFrames), m_measuredFrames(measuredFrames) {
+    for(auto &samples : m_samples) {
+        samples.reserve(measuredFrames);
+    }
+}
+
+/**
+ * 跳过的帧 (窗口最小化, 交换链过期) 不计数也不记录
+ * @param cpuFrameMs 主循环一次迭代的总耗时, 含事件处理
+ * @param timings
+ */
+void Benchmark::AddFrame(double cpuFrameMs, const FrameTimings &timings) {
+    if(!timings.rendered) {
+        return;
+    }
+    m_renderedFrames++;
+    if(!this->IsMeasuring()) {
+        return;
+    }
+
+    m_measuredTimeMs += cpuFrameMs;
+    m_samples[eCpuFrame].push_back(cpuFrameMs);
+    m_samples[eFenceWait].push_back(timings.fenceWaitMs);
+    m_samples[eAcquire].push_back(timings.acquireMs);
+    m_samples[eRecord].push_back(timings.recordMs);
+    m_samples[eSubmit].push_back(timings.submitMs);
+    m_samples[ePresent].push_back(timings.presentMs);
+    // 非阻塞的模式下并不是每帧都能确认一次显示
+    if(timings.inputToPresentMs > 0.0) {
+        m_samples[eInputToPresent].push_back(timings.inputToPresentMs);
+    }
+}
+
+void Benchmark::WriteReport(const std::string &fileName, const RenderSettings &settings, const std::string &deviceName, Size extent) const {
+    const auto measured = m_samples[eCpuFrame].size();
+    const auto averageFps = m_measuredTimeMs > 0.0 ? measured * 1000.0 / m_measuredTimeMs : 0.0;
+
+    fmt::memory_buffer json;
+    auto out = std::back_inserter(json);
+    fmt::format_to(out, "{{\n");
+    fmt::format_to(out, "  \"device\": \"{}\",\n", escapeJson(deviceName));
+    fmt::format_to(out, "  \"headless\": {},\n", settings.headless);
+    fmt::format_to(out, "  \"framesInFlight\": {},\n", settings.framesInFlight);
+    fmt::format_to(out, "  \"gpuCulling\": {},\n", settings.gpuCulling);
+    fmt::format_to(out, "  \"asyncCompute\": {},\n", settings.asyncCompute);
+    fmt::format_to(out, "  \"pipelineLibrary\": {},\n", settings.pipelineLibrary);
+    fmt::format_to(out, "  \"latencyMode\": \"{}\",\n", magic_enum::enum_name(settings.latencyMode));
+    fmt::format_to(out, "  \"frameRateCap\": {},\n", settings.frameRateCap);
+    fmt::format_to(out, "  \"textures\": {},\n", settings.textureFiles.size());
+    fmt::format_to(out, "  \"textureBudgetMB\": {},\n", settings.textureBudgetMB);
+    fmt::format_to(out, "  \"sceneInstances\": {},\n", settings.sceneInstances);
+    fmt::format_to(out, "  \"sceneMeshes\": {},\n", settings.sceneMeshes);
+    fmt::format_to(out, "  \"instancedSubmission\": {},\n", settings.instancedSubmission);
+    fmt::format_to(out, "  \"extent\": [{}, {}],\n", extent.width, extent.height);
+    fmt::format_to(out, "  \"warmupFrames\": {},\n", m_warmupFrames);
+    fmt::format_to(out, "  \"measuredFrames\": {},\n", measured);
+    fmt::format_to(out, "  \"averageFps\": {:.3f},\n", averageFps);
+    fmt::format_to(out, "  \"metrics\": {{\n");
+    for(auto i = 0; i < eMetricCount; i++) {
+        const auto summary = Summarize(m_samples[i]);
+        fmt::format_to(out, "    \"{}\": {{ \"min\": {:.4f}, \"mean\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f} }}{}\n",
+            METRIC_NAMES[i], summary.min, summary.mean, summary.p50, summary.p95, summary.p99, summary.max, i + 1 < eMetricCount ? "," : "");
+        Log::Info("[Benchmark] {:<12} min {:.3f} mean {:.3f} p50 {:.3f} p95 {:.3f} p99 {:.3f} ms",
+            METRIC_NAMES[i], summary.min, summary.mean, summary.p50, summary.p95, summary.p99);
+    }
+    fmt::format_to(out, "  }}\n");
+    fmt::format_to(out, "}}\n");
+
+    std::ofstream file(fileName, std::ios::trunc);
+    if(!file.is_open()) {
+        Log::Error("Failed to write benchmark report {}!", fileName);
+        return;
+    }
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    Log::Info("[Benchmark] {} frames measured ({:.1f} fps), report written to {}", measured, averageFps, fileName);
+}
@@ -0,0 +1,56 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 15:00
+* @version: 1.0
+* @description: 基准模式: 丢弃预热帧后逐帧记录各阶段耗时, 结束时输出 min/mean/p50/p95/p99 的 JSON 报告
+********************************************************************************/
+
+#ifndef VULKAN_START_BENCHMARK_H
+#define VULKAN_START_BENCHMARK_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "../BaseDefine.h"
+
+struct FrameTimings;
+
+class Benchmark {
+public:
+    Benchmark(uint32_t warmupFrames, uint32_t measuredFrames);
+
+    void AddFrame(double cpuFrameMs, const FrameTimings &timings);
+    [[nodiscard]] bool IsMeasuring() const { return m_renderedFrames > m_warmupFrames; }
+    [[nodiscard]] bool IsComplete() const { return m_renderedFrames >= m_warmupFrames + m_measuredFrames; }
+
+    /**
+     * @param fileName JSON 输出路径
+     * @param settings 写入报告的运行配置, 便于比较不同提交的结果
+     * @param deviceName
+     * @param extent 渲染分辨率
+     */
+    void WriteReport(const std::string &fileName, const RenderSettings &settings, const std::string &deviceName, Size extent) const;
+
+private:
+    enum Metric {
+        eCpuFrame,
+        eFenceWait,
+        eAcquire,
+        eRecord,
+        eSubmit,
+        ePresent,
+        eInputToPresent,                                        // 没有 present wait 时到 GPU 完成为止
+        eMetricCount
+    };
+
+private:
+    uint32_t m_warmupFrames = 0;
+    uint32_t m_measuredFrames = 0;
+    uint32_t m_renderedFrames = 0;
+    double m_measuredTimeMs = 0.0;
+    std::array<std::vector<double>, eMetricCount> m_samples;
+};
+
+
+#endif //VULKAN_START_BENCHMARK_H
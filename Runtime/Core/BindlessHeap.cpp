@@ -0,0 +1,219 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 18:00
+* @version: 1.0
+* @description: 全局 bindless 描述符堆: 一个 update-after-bind 描述符集, 着色器通过推送常量中的下标访问采样图像, 采样器和存储缓冲
+********************************************************************************/
+
+#include "BindlessHeap.h"
+#include <algorithm>
+#include "Foundation/Log.h"
+
+constexpr uint32_t MAX_BINDLESS_SAMPLED_IMAGES = 65536;
+constexpr uint32_t MAX_BINDLESS_SAMPLERS = 1024;
+constexpr uint32_t MAX_BINDLESS_STORAGE_BUFFERS = 65536;
+constexpr uint32_t BINDLESS_PUSH_CONSTANT_SIZE = 128;          // Vulkan 保证的 maxPushConstantsSize 下限
+
+constexpr VkDescriptorType DESCRIPTOR_TYPES[] = {
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+    VK_DESCRIPTOR_TYPE_SAMPLER,
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+};
+
+BindlessHeap::BindlessHeap(VkDevice device, VkPhysicalDevice physicalDevice)
+    : m_device(device) {
+    this->queryCapacities(physicalDevice);
+    this->createSetLayout();
+    this->createDescriptorSet();
+
+    Log::Info("Bindless heap: {} sampled images, {} samplers, {} storage buffers",
+        this->GetCapacity(BindlessResourceType::eSampledImage), this->GetCapacity(BindlessResourceType::eSampler),
+        this->GetCapacity(BindlessResourceType::eStorageBuffer));
+}
+
+BindlessHeap::~BindlessHeap() {
+    vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+}
+
+/**
+ * 数组长度取期望值和 update-after-bind 限制中的较小者, 所有绑定对全部着色器阶段可见, 还要满足每阶段的总资源数限制
+ * @param physicalDevice
+ */
+void BindlessHeap::queryCapacities(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+    };
+    VkPhysicalDeviceProperties2 properties2 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &indexingProperties,
+    };
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    auto sampledImages = std::min({ MAX_BINDLESS_SAMPLED_IMAGES, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                    indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages });
+    auto samplers = std::min({ MAX_BINDLESS_SAMPLERS, indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                               indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers });
+    auto storageBuffers = std::min({ MAX_BINDLESS_STORAGE_BUFFERS, indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                     indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+
+    // 超出每阶段资源总数时按比例缩小图像和缓冲数组, 采样器数量很少, 保持不变
+    const auto maxResources = indexingProperties.maxPerStageUpdateAfterBindResources;
+    if(static_cast<uint64_t>(sampledImages) + samplers + storageBuffers > maxResources) {
+        const auto available = maxResources > samplers ? maxResources - samplers : 0;
+        const auto total = static_cast<uint64_t>(sampledImages) + storageBuffers;
+        sampledImages = static_cast<uint32_t>(static_cast<uint64_t>(sampledImages) * available / total);
+        storageBuffers = static_cast<uint32_t>(static_cast<uint64_t>(storageBuffers) * available / total);
+    }
+
+    m_allocators = { IndexAllocator(sampledImages), IndexAllocator(samplers), IndexAllocator(storageBuffers) };
+}
+
+void BindlessHeap::createSetLayout() {
+    std::array<VkDescriptorSetLayoutBinding, static_cast<size_t>(BindlessResourceType::eCount)> bindings {};
+    std::array<VkDescriptorBindingFlags, static_cast<size_t>(BindlessResourceType::eCount)> bindingFlags {};
+    for(uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i] = {
+            .binding = i,
+            .descriptorType = DESCRIPTOR_TYPES[i],
+            .descriptorCount = m_allocators[i].GetCapacity(),
+            .stageFlags = VK_SHADER_STAGE_ALL,
+            .pImmutableSamplers = nullptr
+        };
+        // 未使用的槽位可以留空, 已绑定的集合在命令缓冲执行期间仍可写入未被访问的槽位
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .pNext = nullptr,
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data()
+    };
+    VkDescriptorSetLayoutCreateInfo layoutCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &bindingFlagsCreateInfo,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+    const auto result = vkCreateDescriptorSetLayout(m_device, &layoutCreateInfo, nullptr, &m_setLayout);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create bindless descriptor set layout!");
+}
+
+// 整个程序只分配这一个描述符集, 之后不再有描述符池的分配和重置
+void BindlessHeap::createDescriptorSet() {
+    std::array<VkDescriptorPoolSize, static_cast<size_t>(BindlessResourceType::eCount)> poolSizes {};
+    for(size_t i = 0; i < poolSizes.size(); i++) {
+        poolSizes[i] = { .type = DESCRIPTOR_TYPES[i], .descriptorCount = m_allocators[i].GetCapacity() };
+    }
+
+    VkDescriptorPoolCreateInfo poolCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data()
+    };
+    auto result = vkCreateDescriptorPool(m_device, &poolCreateInfo, nullptr, &m_descriptorPool);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create bindless descriptor pool!");
+
+    VkDescriptorSetAllocateInfo allocateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .descriptorPool = m_descriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &m_setLayout
+    };
+    result = vkAllocateDescriptorSets(m_device, &allocateInfo, &m_descriptorSet);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate bindless descriptor set!");
+}
+
+void BindlessHeap::BeginFrame(uint64_t frameValue, uint64_t completedValue) {
+    m_frameValue = frameValue;
+    std::erase_if(m_pendingReleases, [&](const PendingRelease &pending) {
+        if(completedValue < pending.releaseValue) {
+            return false;
+        }
+        m_allocators[static_cast<size_t>(pending.handle.type)].Free(pending.handle.index);
+        return true;
+    });
+}
+
+BindlessHandle BindlessHeap::allocate(BindlessResourceType type) {
+    BindlessHandle handle { .type = type, .index = m_allocators[static_cast<size_t>(type)].Allocate() };
+    Log::WarningIf(!handle.IsValid(), "Bindless heap is full for descriptor type {}", static_cast<uint32_t>(type));
+    return handle;
+}
+
+void BindlessHeap::writeDescriptor(BindlessHandle handle, const VkDescriptorImageInfo *imageInfo, const VkDescriptorBufferInfo *bufferInfo) {
+    VkWriteDescriptorSet write {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = nullptr,
+        .dstSet = m_descriptorSet,
+        .dstBinding = static_cast<uint32_t>(handle.type),
+        .dstArrayElement = handle.index,
+        .descriptorCount = 1,
+        .descriptorType = DESCRIPTOR_TYPES[static_cast<size_t>(handle.type)],
+        .pImageInfo = imageInfo,
+        .pBufferInfo = bufferInfo,
+        .pTexelBufferView = nullptr
+    };
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+}
+
+BindlessHandle BindlessHeap::RegisterSampledImage(VkImageView imageView, VkImageLayout layout) {
+    const auto handle = this->allocate(BindlessResourceType::eSampledImage);
+    if(handle.IsValid()) {
+        this->UpdateSampledImage(handle, imageView, layout);
+    }
+    return handle;
+}
+
+/**
+ * 替换槽位中的图像视图, 下标不变, 例如纹理流式加载到更高精度的 mip 之后
+ * @param handle
+ * @param imageView
+ * @param layout
+ */
+void BindlessHeap::UpdateSampledImage(BindlessHandle handle, VkImageView imageView, VkImageLayout layout) {
+    const VkDescriptorImageInfo imageInfo { .sampler = VK_NULL_HANDLE, .imageView = imageView, .imageLayout = layout };
+    this->writeDescriptor(handle, &imageInfo, nullptr);
+}
+
+BindlessHandle BindlessHeap::RegisterSampler(VkSampler sampler) {
+    const auto handle = this->allocate(BindlessResourceType::eSampler);
+    if(handle.IsValid()) {
+        const VkDescriptorImageInfo imageInfo { .sampler = sampler, .imageView = VK_NULL_HANDLE, .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED };
+        this->writeDescriptor(handle, &imageInfo, nullptr);
+    }
+    return handle;
+}
+
+BindlessHandle BindlessHeap::RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    const auto handle = this->allocate(BindlessResourceType::eStorageBuffer);
+    if(handle.IsValid()) {
+        const VkDescriptorBufferInfo bufferInfo { .buffer = buffer, .offset = offset, .range = range };
+        this->writeDescriptor(handle, nullptr, &bufferInfo);
+    }
+    return handle;
+}
+
+// 槽位可能仍被 in-flight 帧访问, 延迟到 BeginFrame 确认这些帧完成后再复用
+void BindlessHeap::Release(BindlessHandle handle) {
+    if(!handle.IsValid()) {
+        return;
+    }
+    m_pendingReleases.push_back({ .handle = handle, .releaseValue = m_frameValue });
+}
+
+void BindlessHeap::Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout) const {
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+}
+
+VkPushConstantRange BindlessHeap::GetPushConstantRange() {
+    return { .stageFlags = VK_SHADER_STAGE_ALL, .offset = 0, .size = BINDLESS_PUSH_CONSTANT_SIZE };
+}
@@ -0,0 +1,87 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 18:00
+* @version: 1.0
+* @description: 全局 bindless 描述符堆: 一个 update-after-bind 描述符集, 着色器通过推送常量中的下标访问采样图像, 采样器和存储缓冲
+********************************************************************************/
+
+#ifndef VULKAN_START_BINDLESSHEAP_H
+#define VULKAN_START_BINDLESSHEAP_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Foundation/IndexAllocator.h"
+#include "Foundation/PreprocessorDirectives.h"
+
+// 与 Shader/Bindless.glsl 中的 binding 编号一致
+enum class BindlessResourceType : uint32_t {
+    eSampledImage = 0,
+    eSampler = 1,
+    eStorageBuffer = 2,
+    eCount
+};
+
+struct BindlessHandle {
+    BindlessResourceType type = BindlessResourceType::eSampledImage;
+    uint32_t index = IndexAllocator::INVALID_INDEX;            // 着色器中数组的下标, 通过推送常量传入
+
+    [[nodiscard]] bool IsValid() const { return index != IndexAllocator::INVALID_INDEX; }
+};
+
+class BindlessHeap {
+public:
+    BindlessHeap(VkDevice device, VkPhysicalDevice physicalDevice);
+    ~BindlessHeap();
+    NON_COPYABLE(BindlessHeap);
+
+    /**
+     * 回收释放时所在帧已经执行完的槽位, 这些帧的命令缓冲不会再访问旧描述符
+     * @param frameValue 本帧提交完成时的时间线值
+     * @param completedValue 同一时间线上已经完成的值
+     */
+    void BeginFrame(uint64_t frameValue, uint64_t completedValue);
+
+    // 注册, 更新和释放不加锁: 只在渲染线程上帧与帧之间 (开始录制之前) 调用, 或在第一帧之前的初始化中调用; 槽位耗尽时返回无效句柄
+    [[nodiscard]] BindlessHandle RegisterSampledImage(VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    [[nodiscard]] BindlessHandle RegisterSampler(VkSampler sampler);
+    [[nodiscard]] BindlessHandle RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    void UpdateSampledImage(BindlessHandle handle, VkImageView imageView, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    void Release(BindlessHandle handle);
+
+    // 每个命令缓冲 (包括二级命令缓冲) 绑定一次, 之后的绘制只更新推送常量
+    void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout) const;
+
+    [[nodiscard]] VkDescriptorSetLayout GetSetLayout() const { return m_setLayout; }
+    [[nodiscard]] static VkPushConstantRange GetPushConstantRange();
+    [[nodiscard]] uint32_t GetCapacity(BindlessResourceType type) const { return m_allocators[static_cast<size_t>(type)].GetCapacity(); }
+
+private:
+    struct PendingRelease {
+        BindlessHandle handle;
+        uint64_t releaseValue = 0;
+    };
+
+private:
+    void queryCapacities(VkPhysicalDevice physicalDevice);
+    void createSetLayout();
+    void createDescriptorSet();
+    BindlessHandle allocate(BindlessResourceType type);
+    void writeDescriptor(BindlessHandle handle, const VkDescriptorImageInfo *imageInfo, const VkDescriptorBufferInfo *bufferInfo);
+
+private:
+    VkDevice m_device = nullptr;
+    uint64_t m_frameValue = 0;
+
+    std::array<IndexAllocator, static_cast<size_t>(BindlessResourceType::eCount)> m_allocators = { IndexAllocator(0), IndexAllocator(0), IndexAllocator(0) };
+    std::vector<PendingRelease> m_pendingReleases;
+
+    VkDescriptorSetLayout m_setLayout = nullptr;
+    VkDescriptorPool m_descriptorPool = nullptr;
+    VkDescriptorSet m_descriptorSet = nullptr;
+};
+
+
+#endif //VULKAN_START_BINDLESSHEAP_H
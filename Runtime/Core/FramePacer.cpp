@@ -0,0 +1,117 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 4:00
+* @version: 1.0
+* @description: 帧节奏控制: 低延迟模式下主线程在上一帧显示后, 按预测的工作时长推迟到刚好赶上下一次垂直同步时才处理输入;
+*               另外可以限制最高帧率. 等待都是休眠而不是自旋
+********************************************************************************/
+
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+#include "VkContext.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+        #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+    #endif
+#endif
+
+constexpr size_t PACING_WINDOW = 64;                            // 预测使用最近多少帧
+constexpr size_t MIN_PACING_SAMPLES = 8;                        // 样本不足时上一帧完成后立即开始
+constexpr double WORK_PERCENTILE = 95.0;                        // 按较慢的帧预测工作时长, 偶尔的慢帧错过垂直同步的代价比多等一点大
+constexpr double REFRESH_PERCENTILE = 10.0;                     // 错过垂直同步的帧显示间隔成倍, 取低分位数作为刷新周期
+constexpr double PACING_MARGIN_MS = 1.0;                        // 预测之外留出的余量
+
+FramePacer::FramePacer(bool lowLatency, uint32_t frameRateCap)
+    : m_lowLatency(lowLatency), m_workMs(PACING_WINDOW), m_refreshMs(PACING_WINDOW) {
+    if(frameRateCap > 0) {
+        m_minFrameInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRateCap));
+    }
+#ifdef _WIN32
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if(m_timer != nullptr) {
+        CloseHandle(m_timer);
+    }
+#endif
+}
+
+FramePacer::Clock::time_point FramePacer::WaitForFrameStart() {
+    Clock::time_point target;
+    {
+        std::unique_lock lock(m_mutex);
+        if(m_lowLatency) {
+            m_condition.wait(lock, [this] { return !m_frameInFlight; });
+            target = m_nextFrameStart;
+        }
+        if(m_minFrameInterval != Clock::duration::zero() && m_frameStart != Clock::time_point{}) {
+            target = std::max(target, m_frameStart + m_minFrameInterval);
+        }
+    }
+    this->sleepUntil(target);
+
+    std::lock_guard lock(m_mutex);
+    m_frameStart = Clock::now();
+    m_frameInFlight = m_lowLatency;
+    return m_frameStart;
+}
+
+/**
+ * 下一帧的开始时刻 = 本帧显示时刻 + 刷新周期 - 预测的工作时长, 使下一帧刚好在下一次垂直同步前完成;
+ * 没有显示时刻 (present wait 不可用) 时在本帧 GPU 完成后立即开始
+ * @param timings
+ */
+void FramePacer::OnFrameFinished(const FrameTimings &timings) {
+    if(!m_lowLatency) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_nextFrameStart = {};
+        if(timings.gpuDoneTime != Clock::time_point{}) {
+            const std::chrono::duration<double, std::milli> work = timings.gpuDoneTime - m_frameStart;
+            m_workMs.AddSample(work.count());
+        }
+        if(timings.displayTime != Clock::time_point{}) {
+            if(m_lastDisplayTime != Clock::time_point{}) {
+                const std::chrono::duration<double, std::milli> refresh = timings.displayTime - m_lastDisplayTime;
+                m_refreshMs.AddSample(refresh.count());
+            }
+            m_lastDisplayTime = timings.displayTime;
+        }
+        if(timings.displayTime != Clock::time_point{} && m_refreshMs.GetCount() >= MIN_PACING_SAMPLES) {
+            const auto delayMs = m_refreshMs.GetPercentile(REFRESH_PERCENTILE) - m_workMs.GetPercentile(WORK_PERCENTILE) - PACING_MARGIN_MS;
+            if(delayMs > 0.0) {
+                m_nextFrameStart = timings.displayTime + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(delayMs));
+            }
+        }
+        m_frameInFlight = false;
+    }
+    m_condition.notify_one();
+}
+
+void FramePacer::sleepUntil(Clock::time_point time) {
+    const auto now = Clock::now();
+    if(time <= now) {
+        return;
+    }
+#ifdef _WIN32
+    if(m_timer != nullptr) {
+        // 相对时间, 单位 100ns, 负数表示相对当前
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>>(time - now).count();
+        if(SetWaitableTimer(m_timer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(m_timer, INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(time);
+}
@@ -0,0 +1,63 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 4:00
+* @version: 1.0
+* @description: 帧节奏控制: 低延迟模式下主线程在上一帧显示后, 按预测的工作时长推迟到刚好赶上下一次垂直同步时才处理输入;
+*               另外可以限制最高帧率. 等待都是休眠而不是自旋
+********************************************************************************/
+
+#ifndef VULKAN_START_FRAMEPACER_H
+#define VULKAN_START_FRAMEPACER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "../BaseDefine.h"
+#include "Foundation/PreprocessorDirectives.h"
+#include "Foundation/Statistics.h"
+
+struct FrameTimings;
+
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param lowLatency 每帧等待上一帧完成后才开始, 不再排队
+     * @param frameRateCap 最高帧率, 0 表示不限制
+     */
+    FramePacer(bool lowLatency, uint32_t frameRateCap);
+    ~FramePacer();
+    NON_COPYABLE(FramePacer);
+
+    // 主线程在处理输入前调用, 返回本帧开始 (处理输入) 的时刻
+    Clock::time_point WaitForFrameStart();
+
+    /**
+     * 渲染线程处理完每个快照后调用, 包括被跳过的快照, 否则低延迟模式下主线程会一直等待
+     * @param timings 本帧的 gpuDoneTime 和 displayTime 用于预测下一帧的开始时刻
+     */
+    void OnFrameFinished(const FrameTimings &timings);
+
+private:
+    void sleepUntil(Clock::time_point time);
+
+private:
+    bool m_lowLatency = false;
+    Clock::duration m_minFrameInterval {};                      // 帧率上限对应的最短间隔, 0 表示不限制
+    void *m_timer = nullptr;                                    // 仅 Windows: 高精度可等待定时器, sleep_until 的精度只有系统时钟粒度
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_frameInFlight = false;                               // 低延迟模式下主线程发布的快照还没处理完
+    Clock::time_point m_frameStart;
+    Clock::time_point m_nextFrameStart;                         // 渲染线程预测的下一帧开始时刻
+    Clock::time_point m_lastDisplayTime;
+    RollingStatistics m_workMs;                                 // 帧开始到 GPU 完成
+    RollingStatistics m_refreshMs;                              // 相邻两帧的显示间隔
+};
+
+
+#endif //VULKAN_START_FRAMEPACER_H
@@ -0,0 +1,263 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 19:00
+* @version: 1.0
+* @description: GPU 驱动渲染: 计算着色器做视锥剔除并压缩可见绘制, 每个网格一次 vkCmdDrawIndexedIndirectCount; 附带 CPU 参考实现用于校验
+********************************************************************************/
+
+#include "GpuCulling.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/matrix_access.hpp>
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+#include "Mesh.h"
+#include "Foundation/Log.h"
+
+constexpr uint32_t CULL_WORKGROUP_SIZE = 64;                    // 与 cull.comp 的 local_size_x 一致
+
+// 与 cull.comp 的推送常量块一致
+struct CullPushConstants {
+    glm::vec4 frustumPlanes[6];
+    uint32_t objectBuffer;
+    uint32_t drawBuffer;
+    uint32_t countBuffer;
+    uint32_t objectCount;
+};
+static_assert(sizeof(CullPushConstants) <= 128);
+
+Frustum Frustum::FromMatrix(const glm::mat4 &viewProjection) {
+    const auto row0 = glm::row(viewProjection, 0);
+    const auto row1 = glm::row(viewProjection, 1);
+    const auto row2 = glm::row(viewProjection, 2);
+    const auto row3 = glm::row(viewProjection, 3);
+
+    Frustum frustum {{ row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 }};
+    for(auto &plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+// 与 cull.comp 的 isVisible 保持同样的运算顺序, 使 CPU 和 GPU 的结果逐对象一致
+bool Frustum::IsSphereVisible(const glm::vec4 &sphere) const {
+    for(const auto &plane : planes) {
+        if(glm::dot(glm::vec3(plane), glm::vec3(sphere)) + plane.w < -sphere.w) {
+            return false;
+        }
+    }
+    return true;
+}
+
+GpuCulling::GpuCulling(VkDevice device, MemoryAllocator &allocator, UploadManager &uploadManager, BindlessHeap &bindlessHeap,
+                       VkPipelineLayout pipelineLayout, uint32_t queueFamily, uint32_t framesInFlight, bool verify)
+    : m_device(device), m_allocator(allocator), m_uploadManager(uploadManager), m_bindlessHeap(bindlessHeap),
+      m_pipelineLayout(pipelineLayout), m_queueFamily(queueFamily), m_verify(verify) {
+    m_frames.resize(framesInFlight);
+}
+
+GpuCulling::~GpuCulling() {
+    Log::InfoIf(m_verify, "[Culling] verification finished, {} mismatched frames", m_mismatchCount);
+    this->releaseBuffers();
+    vkDestroyPipeline(m_device, m_pipeline, nullptr);
+}
+
+// 调用前由外部保证没有 in-flight 帧引用这些缓冲
+void GpuCulling::releaseBuffers() {
+    m_bindlessHeap.Release(m_objectHandle);
+    m_objectHandle = {};
+    m_objectBuffer.reset();
+    for(auto &frame : m_frames) {
+        m_bindlessHeap.Release(frame.drawHandle);
+        m_bindlessHeap.Release(frame.countHandle);
+        frame = {};
+    }
+}
+
+void GpuCulling::SetObjects(std::vector<CullObject> objects, std::span<const Mesh *const> objectMeshes) {
+    this->releaseBuffers();
+    m_objects = std::move(objects);
+    m_groups.clear();
+    if(m_objects.empty()) {
+        return;
+    }
+
+    // 按网格首次出现的顺序分组, 每组在间接绘制缓冲中占据连续的 maxDraws 个位置
+    for(size_t i = 0; i < m_objects.size(); i++) {
+        auto group = std::find_if(m_groups.begin(), m_groups.end(), [&](const Group &each) { return each.mesh == objectMeshes[i]; });
+        if(group == m_groups.end()) {
+            group = m_groups.insert(m_groups.end(), { .mesh = objectMeshes[i] });
+        }
+        m_objects[i].group = static_cast<uint32_t>(group - m_groups.begin());
+        group->maxDraws++;
+    }
+    uint32_t drawBase = 0;
+    for(auto &group : m_groups) {
+        group.drawBase = drawBase;
+        drawBase += group.maxDraws;
+    }
+    for(auto &object : m_objects) {
+        object.drawBase = m_groups[object.group].drawBase;
+    }
+
+    const auto objectBytes = m_objects.size() * sizeof(CullObject);
+    m_objectBuffer = m_allocator.CreateBuffer({
+        .size = objectBytes,
+        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    });
+    m_uploadManager.UploadBuffer(*m_objectBuffer, 0, m_objects.data(), objectBytes,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, m_queueFamily);
+    m_objectHandle = m_bindlessHeap.RegisterStorageBuffer(m_objectBuffer->GetHandle());
+
+    for(auto &frame : m_frames) {
+        frame.drawBuffer = m_allocator.CreateBuffer({
+            .size = m_objects.size() * sizeof(VkDrawIndexedIndirectCommand),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        });
+        frame.countBuffer = m_allocator.CreateBuffer({
+            .size = m_groups.size() * sizeof(uint32_t),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        });
+        frame.drawHandle = m_bindlessHeap.RegisterStorageBuffer(frame.drawBuffer->GetHandle());
+        frame.countHandle = m_bindlessHeap.RegisterStorageBuffer(frame.countBuffer->GetHandle());
+        if(m_verify) {
+            frame.countReadback = m_allocator.CreateBuffer({
+                .size = m_groups.size() * sizeof(uint32_t),
+                .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                .domain = MemoryDomain::eReadback,
+            });
+        }
+    }
+    Log::Info("[Culling] {} objects in {} indirect draw groups", m_objects.size(), m_groups.size());
+}
+
+/**
+ * 清零计数 -> 剔除并压缩 -> (校验模式) 拷贝计数到主机可见内存; 各步骤之间的屏障由帧图生成.
+ * 异步计算时两个缓冲在剔除队列上不获取所有权直接写入: 内容会被整体覆盖, 不需要保留绘制队列上一次的内容
+ */
+GpuCulling::FrameOutputs GpuCulling::AddPasses(RenderGraph &cullGraph, RenderGraph &drawGraph, uint32_t frameIndex, const Frustum &frustum) {
+    auto &frame = m_frames[frameIndex];
+    if(m_objects.empty()) {
+        return {};
+    }
+
+    const FrameOutputs outputs {
+        .drawBuffer = cullGraph.ImportBuffer("CullDraws", {
+            .buffer = frame.drawBuffer->GetHandle(),
+            .releaseTo = drawGraph.GetQueueFamily(),
+        }),
+        .countBuffer = cullGraph.ImportBuffer("CullCounts", {
+            .buffer = frame.countBuffer->GetHandle(),
+            .releaseTo = drawGraph.GetQueueFamily(),
+        }),
+    };
+
+    cullGraph.AddPass("CullClear", [&](RenderGraphBuilder &builder) {
+        builder.Write(outputs.countBuffer, ResourceUsage::eTransferDst);
+    }, [this, frameIndex](VkCommandBuffer cmd) {
+        vkCmdFillBuffer(cmd, m_frames[frameIndex].countBuffer->GetHandle(), 0, VK_WHOLE_SIZE, 0);
+    });
+
+    CullPushConstants pushConstants {
+        .objectBuffer = m_objectHandle.index,
+        .drawBuffer = frame.drawHandle.index,
+        .countBuffer = frame.countHandle.index,
+        .objectCount = static_cast<uint32_t>(m_objects.size()),
+    };
+    std::copy(frustum.planes.begin(), frustum.planes.end(), pushConstants.frustumPlanes);
+    cullGraph.AddPass("Cull", [&](RenderGraphBuilder &builder) {
+        builder.Write(outputs.countBuffer, ResourceUsage::eStorageWrite);
+        builder.Write(outputs.drawBuffer, ResourceUsage::eStorageWrite);
+    }, [this, pushConstants](VkCommandBuffer cmd) {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        m_bindlessHeap.Bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout);
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(pushConstants), &pushConstants);
+        vkCmdDispatch(cmd, (pushConstants.objectCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+    });
+
+    if(m_verify) {
+        frame.expectedCounts.assign(m_groups.size(), 0);
+        GpuCulling::CullOnCpu(m_objects, frustum, frame.expectedCounts);
+        frame.pendingVerify = true;
+
+        const auto readback = cullGraph.ImportBuffer("CullCountReadback", {
+            .buffer = frame.countReadback->GetHandle(),
+            .finalUsage = ResourceUsage::eHostRead,
+        });
+        cullGraph.AddPass("CullReadback", [&](RenderGraphBuilder &builder) {
+            builder.Read(outputs.countBuffer, ResourceUsage::eTransferSrc);
+            builder.Write(readback, ResourceUsage::eTransferDst);
+        }, [this, frameIndex](VkCommandBuffer cmd) {
+            const auto &frame = m_frames[frameIndex];
+            const VkBufferCopy region { .srcOffset = 0, .dstOffset = 0, .size = frame.countBuffer->GetSize() };
+            vkCmdCopyBuffer(cmd, frame.countBuffer->GetHandle(), frame.countReadback->GetHandle(), 1, &region);
+        });
+    }
+
+    if(&cullGraph == &drawGraph) {
+        return outputs;
+    }
+    return {
+        .drawBuffer = drawGraph.ImportBuffer("CullDraws", {
+            .buffer = frame.drawBuffer->GetHandle(),
+            .acquireFrom = cullGraph.GetQueueFamily(),
+        }),
+        .countBuffer = drawGraph.ImportBuffer("CullCounts", {
+            .buffer = frame.countBuffer->GetHandle(),
+            .acquireFrom = cullGraph.GetQueueFamily(),
+        }),
+    };
+}
+
+// 在动态渲染实例内录制; CPU 开销与对象数量无关, 只与网格组数有关
+void GpuCulling::RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex) const {
+    const auto &frame = m_frames[frameIndex];
+    for(uint32_t i = 0; i < m_groups.size(); i++) {
+        const auto &group = m_groups[i];
+        group.mesh->Bind(commandBuffer);
+        vkCmdDrawIndexedIndirectCount(commandBuffer,
+            frame.drawBuffer->GetHandle(), group.drawBase * sizeof(VkDrawIndexedIndirectCommand),
+            frame.countBuffer->GetHandle(), i * sizeof(uint32_t),
+            group.maxDraws, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+bool GpuCulling::VerifyFrame(uint32_t frameIndex) {
+    auto &frame = m_frames[frameIndex];
+    if(!frame.pendingVerify) {
+        return true;
+    }
+    frame.pendingVerify = false;
+
+    frame.countReadback->Invalidate();
+    const auto *counts = static_cast<const uint32_t *>(frame.countReadback->GetMappedData());
+    bool matched = true;
+    for(size_t i = 0; i < frame.expectedCounts.size(); i++) {
+        if(counts[i] != frame.expectedCounts[i]) {
+            Log::Error("[Culling] group {}: GPU visible {} != CPU reference {}", i, counts[i], frame.expectedCounts[i]);
+            matched = false;
+        }
+    }
+    m_mismatchCount += matched ? 0 : 1;
+    return matched;
+}
+
+/**
+ * CPU 参考剔除, 与 cull.comp 使用同样的可见性判定
+ * @param objects
+ * @param frustum
+ * @param groupCounts 每组可见对象数, 长度不小于组数, 调用前清零
+ * @return 可见对象总数
+ */
+uint32_t GpuCulling::CullOnCpu(std::span<const CullObject> objects, const Frustum &frustum, std::span<uint32_t> groupCounts) {
+    uint32_t visibleCount = 0;
+    for(const auto &object : objects) {
+        if(frustum.IsSphereVisible(object.boundingSphere)) {
+            groupCounts[object.group]++;
+            visibleCount++;
+        }
+    }
+    return visibleCount;
+}
@@ -0,0 +1,134 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 19:00
+* @version: 1.0
+* @description: GPU 驱动渲染: 计算着色器做视锥剔除并压缩可见绘制, 每个网格一次 vkCmdDrawIndexedIndirectCount; 附带 CPU 参考实现用于校验
+********************************************************************************/
+
+#ifndef VULKAN_START_GPUCULLING_H
+#define VULKAN_START_GPUCULLING_H
+
+#include <array>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include "BindlessHeap.h"
+#include "RenderGraph.h"
+#include "Foundation/PreprocessorDirectives.h"
+
+class MemoryAllocator;
+class UploadManager;
+class GpuBuffer;
+class Mesh;
+
+struct Frustum {
+    std::array<glm::vec4, 6> planes;                            // 法线朝内, xyz 已归一化
+
+    // 适用于 Vulkan 的裁剪空间 (z 属于 [0, w])
+    static Frustum FromMatrix(const glm::mat4 &viewProjection);
+    [[nodiscard]] bool IsSphereVisible(const glm::vec4 &sphere) const;
+};
+
+// 与 Shader/cull.comp 中的 CullObject 布局一致 (std430)
+struct CullObject {
+    glm::vec4 boundingSphere;                                   // 世界空间球心 xyz, 半径 w
+    VkDrawIndexedIndirectCommand command;
+    uint32_t group = 0;                                         // 所属网格组, 每组一次间接绘制
+    uint32_t drawBase = 0;                                      // 该组在间接绘制缓冲中的起始位置
+    uint32_t padding = 0;
+};
+static_assert(sizeof(CullObject) == 48);
+
+class GpuCulling {
+public:
+    // 本帧在绘制帧图中的输出, 主通道以 eIndirectBuffer 读取
+    struct FrameOutputs {
+        RenderGraphHandle drawBuffer;
+        RenderGraphHandle countBuffer;
+    };
+
+    /**
+     * 剔除管线由 PipelineCompiler 异步创建, 通过 ReplacePipeline 换入; 换入之前不能调用 AddPasses
+     * @param pipelineLayout 全局的 bindless 管线布局
+     * @param queueFamily 执行剔除的队列族, 对象缓冲上传后由它获取所有权
+     * @param verify 每帧把 GPU 可见数量读回并与 CPU 参考结果比较
+     */
+    GpuCulling(VkDevice device, MemoryAllocator &allocator, UploadManager &uploadManager, BindlessHeap &bindlessHeap,
+               VkPipelineLayout pipelineLayout, uint32_t queueFamily, uint32_t framesInFlight, bool verify);
+    ~GpuCulling();
+    NON_COPYABLE(GpuCulling);
+
+    /**
+     * 设置参与剔除的对象, 同一组的对象必须使用同一个网格
+     * @param objects group 和 drawBase 由此函数按 meshes 的顺序填写
+     * @param objectMeshes 每个对象对应的网格
+     */
+    void SetObjects(std::vector<CullObject> objects, std::span<const Mesh *const> objectMeshes);
+
+    /**
+     * @param cullGraph 执行剔除的帧图, 其队列族必须与构造时的 queueFamily 一致
+     * @param drawGraph 执行间接绘制的帧图; 与 cullGraph 不同时两者分属不同队列, 绘制参数和计数缓冲在两者之间转移所有权,
+     *                  drawGraph 的提交需要等待 cullGraph 的提交
+     * @param frameIndex
+     * @param frustum
+     */
+    FrameOutputs AddPasses(RenderGraph &cullGraph, RenderGraph &drawGraph, uint32_t frameIndex, const Frustum &frustum);
+    void RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+
+    /**
+     * 在该帧槽位上一次的图形提交完成之后调用: 比较上一次在该槽位执行的 GPU 剔除结果与录制时的 CPU 参考结果
+     * @return 结果不一致时返回 false
+     */
+    bool VerifyFrame(uint32_t frameIndex);
+    [[nodiscard]] uint64_t GetMismatchCount() const { return m_mismatchCount; }
+
+    // 在帧边界换入新管线, 返回的旧管线由调用方在引用它的帧完成后销毁
+    VkPipeline ReplacePipeline(VkPipeline pipeline) { return std::exchange(m_pipeline, pipeline); }
+    [[nodiscard]] bool HasPipeline() const { return m_pipeline != nullptr; }
+
+    static uint32_t CullOnCpu(std::span<const CullObject> objects, const Frustum &frustum, std::span<uint32_t> groupCounts);
+
+private:
+    struct FrameResources {
+        std::unique_ptr<GpuBuffer> drawBuffer;
+        std::unique_ptr<GpuBuffer> countBuffer;
+        std::unique_ptr<GpuBuffer> countReadback;               // 仅校验模式
+        BindlessHandle drawHandle;
+        BindlessHandle countHandle;
+        std::vector<uint32_t> expectedCounts;                   // 录制时 CPU 参考剔除的每组可见数量
+        bool pendingVerify = false;
+    };
+
+    struct Group {
+        const Mesh *mesh = nullptr;
+        uint32_t drawBase = 0;
+        uint32_t maxDraws = 0;
+    };
+
+private:
+    void releaseBuffers();
+
+private:
+    VkDevice m_device = nullptr;
+    MemoryAllocator &m_allocator;
+    UploadManager &m_uploadManager;
+    BindlessHeap &m_bindlessHeap;
+    VkPipelineLayout m_pipelineLayout = nullptr;
+    VkPipeline m_pipeline = nullptr;
+    uint32_t m_queueFamily = 0;
+    bool m_verify = false;
+
+    std::vector<CullObject> m_objects;
+    std::vector<Group> m_groups;
+    std::unique_ptr<GpuBuffer> m_objectBuffer;
+    BindlessHandle m_objectHandle;
+    std::vector<FrameResources> m_frames;
+    uint64_t m_mismatchCount = 0;
+};
+
+
+#endif //VULKAN_START_GPUCULLING_H
@@ -0,0 +1,253 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 10:00
+* @version: 1.0
+* @description: 基于时间戳查询的 GPU 分析器, 支持嵌套作用域和可选的管线统计查询
+********************************************************************************/
+
+#include "GpuProfiler.h"
+#include <array>
+#include "Foundation/Log.h"
+
+constexpr uint32_t MAX_PROFILE_SCOPES = 256;                    // 每帧作用域上限, 每个作用域占两个时间戳
+constexpr uint32_t MAX_STATISTICS_SCOPES = 32;
+constexpr size_t PROFILE_HISTORY_SIZE = 240;
+constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTIC_FLAGS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t PIPELINE_STATISTIC_COUNT = 5;
+
+GpuProfiler::GpuProfiler(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t framesInFlight, bool enablePipelineStatistics)
+    : m_device(device), m_pipelineStatisticsEnabled(enablePipelineStatistics) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // timestampValidBits 为 0 的队列不支持时间戳, 此时分析器所有调用都是空操作
+    const auto validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+    m_enabled = validBits > 0 && properties.limits.timestampPeriod > 0.0f;
+    Log::WarningIf(!m_enabled, "GPU timestamps are not supported on this queue, GPU profiling disabled.");
+    if(!m_enabled) {
+        return;
+    }
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    m_timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    m_frames.resize(framesInFlight);
+    for(auto &frame : m_frames) {
+        VkQueryPoolCreateInfo timestampPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = MAX_PROFILE_SCOPES * 2,
+        };
+        auto result = vkCreateQueryPool(m_device, &timestampPoolCreateInfo, nullptr, &frame.timestampPool);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create timestamp query pool!");
+
+        if(m_pipelineStatisticsEnabled) {
+            VkQueryPoolCreateInfo statisticsPoolCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .pNext = nullptr,
+                .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                .queryCount = MAX_STATISTICS_SCOPES,
+                .pipelineStatistics = PIPELINE_STATISTIC_FLAGS,
+            };
+            result = vkCreateQueryPool(m_device, &statisticsPoolCreateInfo, nullptr, &frame.statisticsPool);
+            Log::ErrorIf(result != VK_SUCCESS, "Failed to create pipeline statistics query pool!");
+        }
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for(auto &frame : m_frames) {
+        vkDestroyQueryPool(m_device, frame.timestampPool, nullptr);
+        if(frame.statisticsPool != nullptr) {
+            vkDestroyQueryPool(m_device, frame.statisticsPool, nullptr);
+        }
+    }
+}
+
+/**
+ * 必须在该帧槽位上一次的图形提交完成之后、命令缓冲开头调用: 先收集槽位上一次的查询结果, 再重置查询池,
+ * 因此读取结果时 GPU 早已完成, 不会阻塞
+ * @param commandBuffer
+ * @param frameIndex
+ */
+void GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if(!m_enabled) return;
+
+    auto &frame = m_frames[frameIndex];
+    this->collectResults(frame);
+
+    vkCmdResetQueryPool(commandBuffer, frame.timestampPool, 0, MAX_PROFILE_SCOPES * 2);
+    if(frame.statisticsPool != nullptr) {
+        vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, 0, MAX_STATISTICS_SCOPES);
+    }
+
+    frame.scopes.clear();
+    frame.timestampCount = 0;
+    frame.statisticsCount = 0;
+    m_currentFrame = &frame;
+    m_scopeStack.clear();
+    m_statisticsActive = false;
+}
+
+/**
+ * 同一时刻只能有一个活动的管线统计查询, 嵌套作用域再请求统计时会被忽略
+ * @param commandBuffer
+ * @param name
+ * @param collectPipelineStatistics
+ */
+void GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, std::string_view name, bool collectPipelineStatistics) {
+    if(!m_enabled || m_currentFrame == nullptr) return;
+
+    auto &frame = *m_currentFrame;
+    ScopeRecord record;
+    record.depth = static_cast<uint32_t>(m_scopeStack.size());
+    record.name = m_scopeStack.empty() ? std::string(name) : frame.scopes[m_scopeStack.back()].name + "/" + std::string(name);
+
+    if(frame.timestampCount + 2 <= MAX_PROFILE_SCOPES * 2) {
+        record.beginQuery = frame.timestampCount;
+        frame.timestampCount += 2;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampPool, record.beginQuery);
+    }
+
+    if(collectPipelineStatistics && m_pipelineStatisticsEnabled && !m_statisticsActive && frame.statisticsCount < MAX_STATISTICS_SCOPES) {
+        record.statisticsQuery = frame.statisticsCount++;
+        vkCmdBeginQuery(commandBuffer, frame.statisticsPool, record.statisticsQuery, 0);
+        m_statisticsActive = true;
+    }
+
+    m_scopeStack.push_back(static_cast<uint32_t>(frame.scopes.size()));
+    frame.scopes.push_back(std::move(record));
+}
+
+VkQueryPipelineStatisticFlags GpuProfiler::GetActiveStatisticFlags() const {
+    return m_statisticsActive ? PIPELINE_STATISTIC_FLAGS : 0;
+}
+
+void GpuProfiler::EndScope(VkCommandBuffer commandBuffer) {
+    if(!m_enabled || m_currentFrame == nullptr || m_scopeStack.empty()) return;
+
+    auto &frame = *m_currentFrame;
+    const auto &record = frame.scopes[m_scopeStack.back()];
+    m_scopeStack.pop_back();
+
+    if(record.statisticsQuery != UINT32_MAX) {
+        vkCmdEndQuery(commandBuffer, frame.statisticsPool, record.statisticsQuery);
+        m_statisticsActive = false;
+    }
+    if(record.beginQuery != UINT32_MAX) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, record.beginQuery + 1);
+    }
+}
+
+void GpuProfiler::collectResults(FrameQueries &frame) {
+    if(frame.timestampCount > 0) {
+        // 每个查询返回 { 值, 可用性 }, 不带 WAIT 标志, 未就绪的作用域直接跳过
+        std::vector<uint64_t> timestamps(frame.timestampCount * 2);
+        vkGetQueryPoolResults(m_device, frame.timestampPool, 0, frame.timestampCount,
+            timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t) * 2,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        for(const auto &record : frame.scopes) {
+            if(record.beginQuery == UINT32_MAX) continue;
+            const auto *begin = &timestamps[record.beginQuery * 2];
+            const auto *end = &timestamps[(record.beginQuery + 1) * 2];
+            if(begin[1] == 0 || end[1] == 0) continue;
+
+            const auto ticks = (end[0] - begin[0]) & m_timestampMask;
+            const auto milliseconds = static_cast<double>(ticks) * m_timestampPeriod / 1e6;
+            this->getHistory(record.name, record.depth).milliseconds.AddSample(milliseconds);
+        }
+    }
+
+    if(frame.statisticsCount > 0) {
+        constexpr uint32_t stride = PIPELINE_STATISTIC_COUNT + 1;
+        std::vector<uint64_t> statistics(frame.statisticsCount * stride);
+        vkGetQueryPoolResults(m_device, frame.statisticsPool, 0, frame.statisticsCount,
+            statistics.size() * sizeof(uint64_t), statistics.data(), sizeof(uint64_t) * stride,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        for(const auto &record : frame.scopes) {
+            if(record.statisticsQuery == UINT32_MAX) continue;
+            const auto *values = &statistics[record.statisticsQuery * stride];
+            if(values[PIPELINE_STATISTIC_COUNT] == 0) continue;
+
+            // 结果按标志位从低到高排列
+            this->getHistory(record.name, record.depth).pipelineStatistics = {
+                .inputAssemblyVertices = values[0],
+                .inputAssemblyPrimitives = values[1],
+                .vertexShaderInvocations = values[2],
+                .clippingPrimitives = values[3],
+                .fragmentShaderInvocations = values[4],
+            };
+        }
+    }
+}
+
+GpuProfiler::ScopeHistory &GpuProfiler::getHistory(const std::string &name, uint32_t depth) {
+    auto iter = m_history.find(name);
+    if(iter == m_history.end()) {
+        iter = m_history.emplace(name, ScopeHistory { .depth = depth, .milliseconds = RollingStatistics(PROFILE_HISTORY_SIZE) }).first;
+        m_scopeOrder.push_back(name);
+    }
+    return iter->second;
+}
+
+const RollingStatistics *GpuProfiler::GetScopeStatistics(std::string_view name) const {
+    const auto iter = m_history.find(std::string(name));
+    return iter == m_history.end() ? nullptr : &iter->second.milliseconds;
+}
+
+const GpuProfiler::PipelineStatistics *GpuProfiler::GetPipelineStatistics(std::string_view name) const {
+    const auto iter = m_history.find(std::string(name));
+    return iter == m_history.end() ? nullptr : &iter->second.pipelineStatistics;
+}
+
+std::vector<GpuProfiler::ScopeReport> GpuProfiler::GetReport() const {
+    std::vector<ScopeReport> report;
+    report.reserve(m_scopeOrder.size());
+    for(const auto &name : m_scopeOrder) {
+        const auto &history = m_history.at(name);
+        report.push_back({ .name = name, .depth = history.depth, .milliseconds = history.milliseconds.GetSummary() });
+    }
+    return report;
+}
+
+void GpuProfiler::LogReport() const {
+    if(!m_enabled) return;
+
+    for(const auto &scope : this->GetReport()) {
+        const auto &ms = scope.milliseconds;
+        Log::Info("[GPU] {:>{}}{}: avg {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms ({} samples)",
+            "", scope.depth * 2, scope.name, ms.mean, ms.p50, ms.p95, ms.p99, ms.count);
+
+        const auto &statistics = m_history.at(scope.name).pipelineStatistics;
+        Log::InfoIf(statistics.inputAssemblyVertices > 0,
+            "[GPU] {:>{}}  vertices {}, primitives {}, vs invocations {}, clipped primitives {}, fs invocations {}",
+            "", scope.depth * 2, statistics.inputAssemblyVertices, statistics.inputAssemblyPrimitives,
+            statistics.vertexShaderInvocations, statistics.clippingPrimitives, statistics.fragmentShaderInvocations);
+    }
+}
+
+GpuProfileScope::GpuProfileScope(GpuProfiler *profiler, VkCommandBuffer commandBuffer, std::string_view name, bool collectPipelineStatistics)
+    : m_profiler(profiler), m_commandBuffer(commandBuffer) {
+    if(m_profiler != nullptr) {
+        m_profiler->BeginScope(m_commandBuffer, name, collectPipelineStatistics);
+    }
+}
+
+GpuProfileScope::~GpuProfileScope() {
+    if(m_profiler != nullptr) {
+        m_profiler->EndScope(m_commandBuffer);
+    }
+}
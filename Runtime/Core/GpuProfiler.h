@@ -0,0 +1,110 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 10:00
+* @version: 1.0
+* @description: 基于时间戳查询的 GPU 分析器, 支持嵌套作用域和可选的管线统计查询
+********************************************************************************/
+
+#ifndef VULKAN_START_GPUPROFILER_H
+#define VULKAN_START_GPUPROFILER_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+#include "Foundation/Statistics.h"
+#include "Foundation/PreprocessorDirectives.h"
+
+class GpuProfiler {
+public:
+    struct PipelineStatistics {
+        uint64_t inputAssemblyVertices = 0;
+        uint64_t inputAssemblyPrimitives = 0;
+        uint64_t vertexShaderInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentShaderInvocations = 0;
+    };
+
+    struct ScopeReport {
+        std::string name;                                       // 以 '/' 连接的嵌套路径, 如 Frame/MainPass
+        uint32_t depth = 0;
+        StatisticsSummary milliseconds;
+    };
+
+public:
+    GpuProfiler(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t framesInFlight, bool enablePipelineStatistics);
+    ~GpuProfiler();
+    NON_COPYABLE(GpuProfiler);
+
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    void BeginScope(VkCommandBuffer commandBuffer, std::string_view name, bool collectPipelineStatistics = false);
+    // 当前激活的管线统计查询标志, 录制在其范围内执行的二级命令缓冲时需要继承
+    [[nodiscard]] VkQueryPipelineStatisticFlags GetActiveStatisticFlags() const;
+    void EndScope(VkCommandBuffer commandBuffer);
+
+    [[nodiscard]] bool IsEnabled() const { return m_enabled; }
+    [[nodiscard]] const RollingStatistics *GetScopeStatistics(std::string_view name) const;
+    [[nodiscard]] const PipelineStatistics *GetPipelineStatistics(std::string_view name) const;
+    [[nodiscard]] std::vector<ScopeReport> GetReport() const;
+    void LogReport() const;
+
+private:
+    struct ScopeRecord {
+        std::string name;
+        uint32_t depth = 0;
+        uint32_t beginQuery = UINT32_MAX;                       // UINT32_MAX 表示查询数超限, 该作用域被丢弃
+        uint32_t statisticsQuery = UINT32_MAX;
+    };
+
+    struct FrameQueries {
+        VkQueryPool timestampPool = nullptr;
+        VkQueryPool statisticsPool = nullptr;
+        std::vector<ScopeRecord> scopes;
+        uint32_t timestampCount = 0;
+        uint32_t statisticsCount = 0;
+    };
+
+    struct ScopeHistory {
+        uint32_t depth = 0;
+        RollingStatistics milliseconds;
+        PipelineStatistics pipelineStatistics;
+    };
+
+private:
+    void collectResults(FrameQueries &frame);
+    ScopeHistory &getHistory(const std::string &name, uint32_t depth);
+
+private:
+    VkDevice m_device = nullptr;
+    bool m_enabled = false;
+    bool m_pipelineStatisticsEnabled = false;
+    double m_timestampPeriod = 1.0;                             // 每个时间戳刻度对应的纳秒数
+    uint64_t m_timestampMask = ~0ull;
+
+    std::vector<FrameQueries> m_frames;
+    FrameQueries *m_currentFrame = nullptr;
+    std::vector<uint32_t> m_scopeStack;
+    bool m_statisticsActive = false;
+
+    std::unordered_map<std::string, ScopeHistory> m_history;
+    std::vector<std::string> m_scopeOrder;                      // 按首次出现的顺序输出报告
+};
+
+/**
+ * RAII 形式的分析作用域, 析构时写入结束时间戳
+ */
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler *profiler, VkCommandBuffer commandBuffer, std::string_view name, bool collectPipelineStatistics = false);
+    ~GpuProfileScope();
+    NON_COPYABLE(GpuProfileScope);
+
+private:
+    GpuProfiler *m_profiler = nullptr;
+    VkCommandBuffer m_commandBuffer = nullptr;
+};
+
+
+#endif //VULKAN_START_GPUPROFILER_H
@@ -0,0 +1,513 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 12:00
+* @version: 1.0
+* @description: 基于 VMA 的 GPU 内存分配模块, 由 VkContext 持有
+********************************************************************************/
+
+#define VMA_IMPLEMENTATION
+#include "MemoryAllocator.h"
+#include "Queue.h"
+#include "Foundation/Log.h"
+
+constexpr VkDeviceSize SMALL_BUFFER_THRESHOLD = 64 * 1024;     // 不超过该大小的设备本地缓冲走小对象池
+constexpr VkDeviceSize SMALL_BUFFER_BLOCK_SIZE = 4 * 1024 * 1024;
+constexpr uint64_t DEDICATED_RENDER_TARGET_PIXELS = 512 * 512;  // 达到该尺寸的渲染目标使用独占分配
+constexpr VkDeviceSize DEFRAGMENT_MAX_BYTES_PER_PASS = 16 * 1024 * 1024; // 每帧最多迁移的字节数和分配数, 限制整理对帧时间的影响
+constexpr uint32_t DEFRAGMENT_MAX_ALLOCATIONS_PER_PASS = 64;
+
+GpuBuffer::~GpuBuffer() {
+    if(m_allocator != nullptr) {
+        m_allocator->destroyBuffer(*this);
+    }
+}
+
+void GpuBuffer::Flush(VkDeviceSize offset, VkDeviceSize size) const {
+    vmaFlushAllocation(m_allocator->GetHandle(), m_allocation, offset, size);
+}
+
+void GpuBuffer::Invalidate(VkDeviceSize offset, VkDeviceSize size) const {
+    vmaInvalidateAllocation(m_allocator->GetHandle(), m_allocation, offset, size);
+}
+
+GpuImage::~GpuImage() {
+    if(m_allocator != nullptr) {
+        m_allocator->destroyImage(*this);
+    }
+}
+
+GpuMemoryBlock::~GpuMemoryBlock() {
+    if(m_allocator != nullptr) {
+        vmaFreeMemory(m_allocator->GetHandle(), m_allocation);
+    }
+}
+
+void GpuMemoryBlock::BindImage(VkImage image, VkDeviceSize offset) const {
+    const auto result = vmaBindImageMemory2(m_allocator->GetHandle(), m_allocation, offset, image, nullptr);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to bind image memory!");
+}
+
+MemoryAllocator::MemoryAllocator(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled)
+    : m_device(device) {
+    // xmake 中定义了 VMA_DYNAMIC_VULKAN_FUNCTIONS=1, 其余函数由 VMA 通过这两个入口自行加载
+    VmaVulkanFunctions vulkanFunctions {};
+    vulkanFunctions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+    vulkanFunctions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
+
+    VmaAllocatorCreateInfo createInfo {};
+    createInfo.flags = memoryBudgetEnabled ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
+    createInfo.physicalDevice = physicalDevice;
+    createInfo.device = device;
+    createInfo.instance = instance;
+    createInfo.pVulkanFunctions = &vulkanFunctions;
+    createInfo.vulkanApiVersion = VK_API_VERSION_1_3;
+
+    const auto result = vmaCreateAllocator(&createInfo, &m_allocator);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create memory allocator!");
+
+    m_smallBufferPool = this->CreatePool({
+        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .domain = MemoryDomain::eDeviceLocal,
+        .blockSize = SMALL_BUFFER_BLOCK_SIZE,
+    });
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    this->EndDefragmentation();
+    this->DestroyPool(m_smallBufferPool);
+    vmaDestroyAllocator(m_allocator);
+}
+
+VmaAllocationCreateInfo MemoryAllocator::getAllocationCreateInfo(MemoryDomain domain) {
+    VmaAllocationCreateInfo allocationCreateInfo {};
+    switch (domain) {
+    case MemoryDomain::eDeviceLocal:
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        break;
+    case MemoryDomain::eUpload:
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        break;
+    case MemoryDomain::eReadback:
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        break;
+    }
+    return allocationCreateInfo;
+}
+
+std::unique_ptr<GpuBuffer> MemoryAllocator::CreateBuffer(const BufferDesc &desc) {
+    // 可迁移的缓冲在碎片整理时需要整块拷贝
+    auto usage = desc.usage;
+    if(desc.movable) {
+        usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    }
+
+    VkBufferCreateInfo bufferCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+        .size = desc.size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+
+    auto allocationCreateInfo = MemoryAllocator::getAllocationCreateInfo(desc.domain);
+    allocationCreateInfo.pool = desc.pool;
+    if(desc.dedicated) {
+        allocationCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    }
+    else if(desc.pool == nullptr && desc.domain == MemoryDomain::eDeviceLocal && desc.size <= SMALL_BUFFER_THRESHOLD) {
+        allocationCreateInfo.pool = m_smallBufferPool;
+    }
+
+    auto buffer = std::unique_ptr<GpuBuffer>(new GpuBuffer());
+    VmaAllocationInfo allocationInfo {};
+    auto result = vmaCreateBuffer(m_allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer->m_buffer, &buffer->m_allocation, &allocationInfo);
+    if(result != VK_SUCCESS && allocationCreateInfo.pool == m_smallBufferPool && desc.pool == nullptr) {
+        // 小对象池的内存类型与该用途不兼容时退回默认池
+        allocationCreateInfo.pool = nullptr;
+        result = vmaCreateBuffer(m_allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer->m_buffer, &buffer->m_allocation, &allocationInfo);
+    }
+    if(result != VK_SUCCESS) {
+        Log::Error("Failed to create buffer of {} bytes!", desc.size);
+        return nullptr;
+    }
+
+    buffer->m_allocator = this;
+    buffer->m_size = desc.size;
+    buffer->m_usage = usage;
+    buffer->m_mapped = allocationInfo.pMappedData;
+    // 碎片整理只迁移带有用户数据的分配, 其余的都忽略
+    vmaSetAllocationUserData(m_allocator, buffer->m_allocation, desc.movable ? buffer.get() : nullptr);
+    return buffer;
+}
+
+std::unique_ptr<GpuImage> MemoryAllocator::CreateImage(const ImageDesc &desc) {
+    VkImageCreateInfo imageCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .imageType = desc.type,
+        .format = desc.format,
+        .extent = desc.extent,
+        .mipLevels = desc.mipLevels,
+        .arrayLayers = desc.arrayLayers,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = desc.tiling,
+        .usage = desc.usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    // 大尺寸渲染目标独占内存块, 驱动可以对其做专门的优化, 也不会在共享块中留下大空洞
+    const auto isRenderTarget = (desc.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) != 0;
+    const auto pixels = static_cast<uint64_t>(desc.extent.width) * desc.extent.height;
+    auto allocationCreateInfo = MemoryAllocator::getAllocationCreateInfo(MemoryDomain::eDeviceLocal);
+    if(desc.dedicated || (isRenderTarget && pixels >= DEDICATED_RENDER_TARGET_PIXELS)) {
+        allocationCreateInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    }
+
+    auto image = std::unique_ptr<GpuImage>(new GpuImage());
+    const auto result = vmaCreateImage(m_allocator, &imageCreateInfo, &allocationCreateInfo, &image->m_image, &image->m_allocation, nullptr);
+    if(result != VK_SUCCESS) {
+        Log::Error("Failed to create image {}x{}!", desc.extent.width, desc.extent.height);
+        return nullptr;
+    }
+
+    image->m_allocator = this;
+    image->m_desc = desc;
+    return image;
+}
+
+/**
+ * 按合并后的内存需求分配一块设备本地内存, 资源由调用方自行创建和绑定
+ * @param requirements 多个资源的 size/alignment 取最大值, memoryTypeBits 取交集
+ * @return
+ */
+std::unique_ptr<GpuMemoryBlock> MemoryAllocator::AllocateMemory(const VkMemoryRequirements &requirements) {
+    // VMA_MEMORY_USAGE_AUTO 需要知道资源的创建信息, 这里只有内存需求, 直接指定内存属性
+    VmaAllocationCreateInfo allocationCreateInfo {};
+    allocationCreateInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    auto block = std::unique_ptr<GpuMemoryBlock>(new GpuMemoryBlock());
+    const auto result = vmaAllocateMemory(m_allocator, &requirements, &allocationCreateInfo, &block->m_allocation, nullptr);
+    if(result != VK_SUCCESS) {
+        Log::Error("Failed to allocate {} bytes of device memory!", requirements.size);
+        return nullptr;
+    }
+
+    block->m_allocator = this;
+    block->m_size = requirements.size;
+    return block;
+}
+
+VmaPool MemoryAllocator::CreatePool(const PoolDesc &desc) {
+    VkBufferCreateInfo bufferCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+        .size = 1024,
+        .usage = desc.usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    const auto allocationCreateInfo = MemoryAllocator::getAllocationCreateInfo(desc.domain);
+
+    uint32_t memoryTypeIndex = 0;
+    auto result = vmaFindMemoryTypeIndexForBufferInfo(m_allocator, &bufferCreateInfo, &allocationCreateInfo, &memoryTypeIndex);
+    if(result != VK_SUCCESS) {
+        Log::Error("Failed to find memory type for pool!");
+        return nullptr;
+    }
+
+    VmaPoolCreateInfo poolCreateInfo {};
+    poolCreateInfo.memoryTypeIndex = memoryTypeIndex;
+    poolCreateInfo.blockSize = desc.blockSize;
+    poolCreateInfo.maxBlockCount = desc.maxBlockCount;
+
+    VmaPool pool = nullptr;
+    result = vmaCreatePool(m_allocator, &poolCreateInfo, &pool);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create memory pool!");
+    return pool;
+}
+
+void MemoryAllocator::DestroyPool(VmaPool pool) {
+    if(pool != nullptr) {
+        vmaDestroyPool(m_allocator, pool);
+    }
+}
+
+void MemoryAllocator::destroyBuffer(GpuBuffer &buffer) {
+    // 正在迁移的分配不能直接释放, 交给 VMA 在结束这一遍时释放; 新句柄绑定在目标内存上, 等拷贝完成再销毁
+    for(auto &move : m_defragmentation.moves) {
+        if(move.buffer == &buffer) {
+            m_defragmentation.pass.pMoves[move.moveIndex].operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+            m_defragmentation.retiredBuffers.push_back(buffer.m_buffer);
+            move.buffer = nullptr;
+            buffer.m_buffer = nullptr;
+            buffer.m_allocation = nullptr;
+            return;
+        }
+    }
+    vmaDestroyBuffer(m_allocator, buffer.m_buffer, buffer.m_allocation);
+    buffer.m_buffer = nullptr;
+    buffer.m_allocation = nullptr;
+}
+
+void MemoryAllocator::destroyImage(GpuImage &image) {
+    vmaDestroyImage(m_allocator, image.m_image, image.m_allocation);
+    image.m_image = nullptr;
+    image.m_allocation = nullptr;
+}
+
+/**
+ * 每帧调用一次, VMA 据此刷新预算数据
+ * @param frameIndex
+ */
+void MemoryAllocator::SetCurrentFrameIndex(uint32_t frameIndex) {
+    vmaSetCurrentFrameIndex(m_allocator, frameIndex);
+}
+
+/**
+ * 整理以增量方式进行, 每帧最多一遍, 拷贝提交到 queue 后不等待 GPU.
+ * 拷贝按提交顺序排在之前的帧之后, 之前对可迁移缓冲的写入 (如上传) 必须已经有 queue 上的提交等待过
+ * @param queue
+ */
+void MemoryAllocator::BeginDefragmentation(Queue &queue) {
+    auto &defragmentation = m_defragmentation;
+    if(defragmentation.queue != nullptr) {
+        return;
+    }
+
+    VkCommandPoolCreateInfo commandPoolCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = queue.GetFamilyIndex()
+    };
+    const auto result = vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &defragmentation.commandPool);
+    if(result != VK_SUCCESS) {
+        Log::Error("Failed to create command pool for defragmentation!");
+        return;
+    }
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = defragmentation.commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &defragmentation.commandBuffer);
+    defragmentation.queue = &queue;
+}
+
+std::vector<GpuBuffer *> MemoryAllocator::UpdateDefragmentation() {
+    auto &defragmentation = m_defragmentation;
+    if(defragmentation.queue == nullptr) {
+        return {};
+    }
+    // 上一遍的拷贝完成前不开始新的一遍
+    if(defragmentation.passValue != 0) {
+        if(defragmentation.queue->IsCompleted(defragmentation.passValue)) {
+            this->endDefragmentationPass();
+        }
+        return {};
+    }
+
+    if(defragmentation.context == nullptr) {
+        const VmaPool pools[] = { nullptr, m_smallBufferPool };
+        if(defragmentation.poolIndex == std::size(pools)) {
+            this->EndDefragmentation();
+            return {};
+        }
+
+        VmaDefragmentationInfo defragmentationInfo {};
+        defragmentationInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+        defragmentationInfo.pool = pools[defragmentation.poolIndex++];
+        defragmentationInfo.maxBytesPerPass = DEFRAGMENT_MAX_BYTES_PER_PASS;
+        defragmentationInfo.maxAllocationsPerPass = DEFRAGMENT_MAX_ALLOCATIONS_PER_PASS;
+        if(vmaBeginDefragmentation(m_allocator, &defragmentationInfo, &defragmentation.context) != VK_SUCCESS) {
+            defragmentation.context = nullptr;
+            return {};
+        }
+    }
+
+    defragmentation.pass = {};
+    if(vmaBeginDefragmentationPass(m_allocator, defragmentation.context, &defragmentation.pass) == VK_SUCCESS) {
+        // 这个池已经没有需要迁移的分配
+        this->endPoolDefragmentation();
+        return {};
+    }
+    return this->recordDefragmentationPass();
+}
+
+void MemoryAllocator::EndDefragmentation() {
+    auto &defragmentation = m_defragmentation;
+    if(defragmentation.queue == nullptr) {
+        return;
+    }
+    if(defragmentation.passValue != 0) {
+        defragmentation.queue->Wait(defragmentation.passValue);
+        this->endDefragmentationPass();
+    }
+    if(defragmentation.context != nullptr) {
+        this->endPoolDefragmentation();
+    }
+
+    const auto &stats = defragmentation.stats;
+    Log::InfoIf(stats.allocationsMoved > 0, "[Memory] defragmentation moved {} allocations ({} bytes), freed {} blocks ({} bytes)",
+        stats.allocationsMoved, stats.bytesMoved, stats.deviceMemoryBlocksFreed, stats.bytesFreed);
+    vkDestroyCommandPool(m_device, defragmentation.commandPool, nullptr);
+    defragmentation = {};
+}
+
+/**
+ * 为本遍每个可迁移的分配在目标内存上创建新缓冲并录制整块拷贝, 提交成功后立即换用新句柄:
+ * 之后录制的帧使用新缓冲, 已经提交的帧继续读取旧缓冲; 旧缓冲和旧内存等拷贝 (以及排在它之前的帧) 完成后才释放
+ * @return 换了句柄的缓冲
+ */
+std::vector<GpuBuffer *> MemoryAllocator::recordDefragmentationPass() {
+    auto &defragmentation = m_defragmentation;
+    const auto commandBuffer = defragmentation.commandBuffer;
+    vkResetCommandPool(m_device, defragmentation.commandPool, 0);
+    VkCommandBufferBeginInfo beginInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    // 之前的提交对源缓冲的写入对拷贝可见, 目标内存上之前的访问也都已结束
+    VkMemoryBarrier2 copyBarrier {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+        .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT,
+    };
+    VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &copyBarrier,
+    };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+    for(uint32_t i = 0; i < defragmentation.pass.moveCount; i++) {
+        auto &move = defragmentation.pass.pMoves[i];
+        VmaAllocationInfo allocationInfo {};
+        vmaGetAllocationInfo(m_allocator, move.srcAllocation, &allocationInfo);
+        auto *buffer = static_cast<GpuBuffer *>(allocationInfo.pUserData);
+        if(buffer == nullptr) {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        VkBufferCreateInfo bufferCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = nullptr,
+            .size = buffer->m_size,
+            .usage = buffer->m_usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        };
+        VkBuffer newBuffer = nullptr;
+        if(vkCreateBuffer(m_device, &bufferCreateInfo, nullptr, &newBuffer) != VK_SUCCESS ||
+           vmaBindBufferMemory(m_allocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS) {
+            vkDestroyBuffer(m_device, newBuffer, nullptr);
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        VkBufferCopy region { .srcOffset = 0, .dstOffset = 0, .size = buffer->m_size };
+        vkCmdCopyBuffer(commandBuffer, buffer->m_buffer, newBuffer, 1, &region);
+        defragmentation.moves.push_back({ .buffer = buffer, .oldBuffer = buffer->m_buffer, .newBuffer = newBuffer, .moveIndex = i });
+    }
+
+    // 之后提交的命令读取到拷贝后的数据
+    copyBarrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+        .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    vkEndCommandBuffer(commandBuffer);
+
+    if(defragmentation.moves.empty()) {
+        this->endDefragmentationPass();
+        return {};
+    }
+
+    defragmentation.passValue = defragmentation.queue->Submit({ &commandBuffer, 1 }, {}, {});
+    if(defragmentation.passValue == 0) {
+        // 拷贝没有执行, 全部保持原位并放弃这一轮整理
+        for(const auto &move : defragmentation.moves) {
+            vkDestroyBuffer(m_device, move.newBuffer, nullptr);
+            defragmentation.pass.pMoves[move.moveIndex].operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+        }
+        defragmentation.moves.clear();
+        defragmentation.passValue = 0;
+        this->endDefragmentationPass();
+        this->EndDefragmentation();
+        return {};
+    }
+
+    std::vector<GpuBuffer *> movedBuffers;
+    for(const auto &move : defragmentation.moves) {
+        defragmentation.retiredBuffers.push_back(move.oldBuffer);
+        move.buffer->m_buffer = move.newBuffer;
+        movedBuffers.push_back(move.buffer);
+    }
+    return movedBuffers;
+}
+
+// 本遍的拷贝已经完成后调用
+void MemoryAllocator::endDefragmentationPass() {
+    auto &defragmentation = m_defragmentation;
+    for(auto buffer : defragmentation.retiredBuffers) {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+    }
+    defragmentation.retiredBuffers.clear();
+    defragmentation.passValue = 0;
+
+    const auto result = vmaEndDefragmentationPass(m_allocator, defragmentation.context, &defragmentation.pass);
+    // 结束后 srcAllocation 指向新内存, 常驻映射的指针也随之变化
+    for(const auto &move : defragmentation.moves) {
+        if(move.buffer != nullptr) {
+            VmaAllocationInfo allocationInfo {};
+            vmaGetAllocationInfo(m_allocator, move.buffer->m_allocation, &allocationInfo);
+            move.buffer->m_mapped = allocationInfo.pMappedData;
+        }
+    }
+    defragmentation.moves.clear();
+    if(result == VK_SUCCESS) {
+        this->endPoolDefragmentation();
+    }
+}
+
+void MemoryAllocator::endPoolDefragmentation() {
+    auto &defragmentation = m_defragmentation;
+    VmaDefragmentationStats stats {};
+    vmaEndDefragmentation(m_allocator, defragmentation.context, &stats);
+    defragmentation.context = nullptr;
+    defragmentation.stats.allocationsMoved += stats.allocationsMoved;
+    defragmentation.stats.bytesMoved += stats.bytesMoved;
+    defragmentation.stats.deviceMemoryBlocksFreed += stats.deviceMemoryBlocksFreed;
+    defragmentation.stats.bytesFreed += stats.bytesFreed;
+}
+
+std::vector<VmaBudget> MemoryAllocator::GetHeapBudgets() const {
+    const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memoryProperties);
+
+    std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+    vmaGetHeapBudgets(m_allocator, budgets.data());
+    return budgets;
+}
+
+void MemoryAllocator::LogBudgets() const {
+    const auto budgets = this->GetHeapBudgets();
+    for(size_t heap = 0; heap < budgets.size(); heap++) {
+        const auto &budget = budgets[heap];
+        Log::Info("[Memory] heap {}: usage {:.1f} / {:.1f} MB, {} allocations ({:.1f} MB) in {} blocks ({:.1f} MB)",
+            heap, budget.usage / 1048576.0, budget.budget / 1048576.0,
+            budget.statistics.allocationCount, budget.statistics.allocationBytes / 1048576.0,
+            budget.statistics.blockCount, budget.statistics.blockBytes / 1048576.0);
+    }
+}
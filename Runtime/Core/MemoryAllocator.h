@@ -0,0 +1,190 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 12:00
+* @version: 1.0
+* @description: 基于 VMA 的 GPU 内存分配模块, 由 VkContext 持有
+********************************************************************************/
+
+#ifndef VULKAN_START_MEMORYALLOCATOR_H
+#define VULKAN_START_MEMORYALLOCATOR_H
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+class MemoryAllocator;
+class Queue;
+
+enum class MemoryDomain {
+    eDeviceLocal,                                               // 仅 GPU 访问
+    eUpload,                                                    // CPU 顺序写入, GPU 读取, 常驻映射
+    eReadback,                                                  // GPU 写入, CPU 随机读取, 常驻映射
+};
+
+struct BufferDesc {
+    VkDeviceSize size = 0;
+    VkBufferUsageFlags usage = 0;
+    MemoryDomain domain = MemoryDomain::eDeviceLocal;
+    bool dedicated = false;                                     // 独占一块 VkDeviceMemory
+    bool movable = false;                                       // 允许碎片整理时迁移, 迁移后 GetHandle() 会变化; 只能在整理所用的队列族上使用
+    VmaPool pool = nullptr;                                     // 为空时由分配器自动选择
+};
+
+struct ImageDesc {
+    VkImageType type = VK_IMAGE_TYPE_2D;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent3D extent = { 1, 1, 1 };
+    uint32_t mipLevels = 1;
+    uint32_t arrayLayers = 1;
+    VkImageUsageFlags usage = 0;
+    VkImageTiling tiling = VK_IMAGE_TILING_OPTIMAL;
+    bool dedicated = false;
+};
+
+struct PoolDesc {
+    VkBufferUsageFlags usage = 0;                               // 用于确定内存类型的代表性用途
+    MemoryDomain domain = MemoryDomain::eDeviceLocal;
+    VkDeviceSize blockSize = 0;                                 // 0 表示使用 VMA 默认值
+    size_t maxBlockCount = 0;
+};
+
+class GpuBuffer {
+public:
+    ~GpuBuffer();
+    NON_COPYABLE(GpuBuffer);
+
+    [[nodiscard]] VkBuffer GetHandle() const { return m_buffer; }
+    [[nodiscard]] VkDeviceSize GetSize() const { return m_size; }
+    [[nodiscard]] VkBufferUsageFlags GetUsage() const { return m_usage; }
+    [[nodiscard]] void *GetMappedData() const { return m_mapped; }
+    [[nodiscard]] VmaAllocation GetAllocation() const { return m_allocation; }
+    void Flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+    void Invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+private:
+    friend class MemoryAllocator;
+    GpuBuffer() = default;
+
+private:
+    MemoryAllocator *m_allocator = nullptr;
+    VkBuffer m_buffer = nullptr;
+    VmaAllocation m_allocation = nullptr;
+    VkDeviceSize m_size = 0;
+    VkBufferUsageFlags m_usage = 0;
+    void *m_mapped = nullptr;
+};
+
+class GpuImage {
+public:
+    ~GpuImage();
+    NON_COPYABLE(GpuImage);
+
+    [[nodiscard]] VkImage GetHandle() const { return m_image; }
+    [[nodiscard]] const ImageDesc &GetDesc() const { return m_desc; }
+    [[nodiscard]] VmaAllocation GetAllocation() const { return m_allocation; }
+
+private:
+    friend class MemoryAllocator;
+    GpuImage() = default;
+
+private:
+    MemoryAllocator *m_allocator = nullptr;
+    VkImage m_image = nullptr;
+    VmaAllocation m_allocation = nullptr;
+    ImageDesc m_desc;
+};
+
+// 不绑定具体资源的设备本地内存, 多个生命周期不重叠的资源可以绑定到同一块上
+class GpuMemoryBlock {
+public:
+    ~GpuMemoryBlock();
+    NON_COPYABLE(GpuMemoryBlock);
+
+    [[nodiscard]] VmaAllocation GetAllocation() const { return m_allocation; }
+    [[nodiscard]] VkDeviceSize GetSize() const { return m_size; }
+    void BindImage(VkImage image, VkDeviceSize offset = 0) const;
+
+private:
+    friend class MemoryAllocator;
+    GpuMemoryBlock() = default;
+
+private:
+    MemoryAllocator *m_allocator = nullptr;
+    VmaAllocation m_allocation = nullptr;
+    VkDeviceSize m_size = 0;
+};
+
+class MemoryAllocator {
+public:
+    MemoryAllocator(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudgetEnabled);
+    ~MemoryAllocator();
+    NON_COPYABLE(MemoryAllocator);
+
+    [[nodiscard]] VmaAllocator GetHandle() const { return m_allocator; }
+
+    [[nodiscard]] std::unique_ptr<GpuBuffer> CreateBuffer(const BufferDesc &desc);
+    [[nodiscard]] std::unique_ptr<GpuImage> CreateImage(const ImageDesc &desc);
+    [[nodiscard]] std::unique_ptr<GpuMemoryBlock> AllocateMemory(const VkMemoryRequirements &requirements);
+    [[nodiscard]] VmaPool CreatePool(const PoolDesc &desc);
+    void DestroyPool(VmaPool pool);
+
+    void SetCurrentFrameIndex(uint32_t frameIndex);
+
+    /**
+     * 开始一轮增量碎片整理, 依次整理默认池和小对象池, 只迁移以 movable 创建的缓冲; 已有一轮在进行时忽略
+     * @param queue 执行迁移拷贝的队列, 可迁移的缓冲都在该队列上使用
+     */
+    void BeginDefragmentation(Queue &queue);
+    // 每帧提交之后调用一次, 推进一遍迁移; 返回本次换了句柄的缓冲, 调用方据此重建引用旧句柄的描述符
+    [[nodiscard]] std::vector<GpuBuffer *> UpdateDefragmentation();
+    // 等待进行中的拷贝并结束整理, 析构前调用
+    void EndDefragmentation();
+
+    [[nodiscard]] std::vector<VmaBudget> GetHeapBudgets() const;
+    void LogBudgets() const;
+
+private:
+    friend class GpuBuffer;
+    friend class GpuImage;
+    friend class GpuMemoryBlock;
+    void destroyBuffer(GpuBuffer &buffer);
+    void destroyImage(GpuImage &image);
+    std::vector<GpuBuffer *> recordDefragmentationPass();
+    void endDefragmentationPass();
+    void endPoolDefragmentation();
+    static VmaAllocationCreateInfo getAllocationCreateInfo(MemoryDomain domain);
+
+private:
+    struct DefragmentationMove {
+        GpuBuffer *buffer = nullptr;                            // 拷贝完成前被销毁时置空
+        VkBuffer oldBuffer = nullptr;
+        VkBuffer newBuffer = nullptr;                           // 绑定在目标内存上, 提交后换入 buffer
+        uint32_t moveIndex = 0;                                 // 在 pass.pMoves 中的下标
+    };
+
+    // 进行中的一轮碎片整理; 每一遍的拷贝提交后, 等时间线到达再结束该遍, 旧的内存区域在结束时才被 VMA 回收
+    struct Defragmentation {
+        Queue *queue = nullptr;                                 // 为空表示没有进行中的整理
+        VkCommandPool commandPool = nullptr;
+        VkCommandBuffer commandBuffer = nullptr;
+        uint32_t poolIndex = 0;                                 // 下一个要整理的池: 0 为默认池, 1 为小对象池
+        VmaDefragmentationContext context = nullptr;
+        VmaDefragmentationPassMoveInfo pass {};
+        uint64_t passValue = 0;                                 // 本遍拷贝的时间线值, 0 表示没有等待中的拷贝
+        std::vector<DefragmentationMove> moves;
+        std::vector<VkBuffer> retiredBuffers;                   // 迁移前的句柄和拷贝期间被销毁的新句柄, passValue 完成后销毁
+        VmaDefragmentationStats stats {};
+    };
+
+private:
+    VkDevice m_device = nullptr;
+    VmaAllocator m_allocator = nullptr;
+    VmaPool m_smallBufferPool = nullptr;                        // 小而频繁的设备本地缓冲集中在这里, 减少块数量和碎片
+    Defragmentation m_defragmentation;
+};
+
+
+#endif //VULKAN_START_MEMORYALLOCATOR_H
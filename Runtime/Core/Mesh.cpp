@@ -0,0 +1,75 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 13:00
+* @version: 1.0
+* @description: 顶点/索引缓冲, 数据经 UploadManager 的暂存环形缓冲上传
+********************************************************************************/
+
+#include "Mesh.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+
+VkVertexInputBindingDescription Vertex::GetBindingDescription() {
+    return {
+        .binding = 0,
+        .stride = sizeof(Vertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+    };
+}
+
+std::array<VkVertexInputAttributeDescription, 2> Vertex::GetAttributeDescriptions() {
+    return {{
+        { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(Vertex, position) },
+        { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(Vertex, color) },
+    }};
+}
+
+Mesh::Mesh(MemoryAllocator &allocator, UploadManager &uploadManager, std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+    : m_vertexCount(static_cast<uint32_t>(vertices.size())), m_indexCount(static_cast<uint32_t>(indices.size())) {
+    m_vertexBuffer = allocator.CreateBuffer({
+        .size = vertices.size_bytes(),
+        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .movable = true,
+    });
+    m_indexBuffer = allocator.CreateBuffer({
+        .size = indices.size_bytes(),
+        .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .movable = true,
+    });
+
+    // 以包围盒中心为球心, 不是最小包围球, 但足够用于剔除
+    glm::vec3 minimum(std::numeric_limits<float>::max());
+    glm::vec3 maximum(std::numeric_limits<float>::lowest());
+    for(const auto &vertex : vertices) {
+        minimum = glm::min(minimum, vertex.position);
+        maximum = glm::max(maximum, vertex.position);
+    }
+    const auto center = (minimum + maximum) * 0.5f;
+    float radius = 0.0f;
+    for(const auto &vertex : vertices) {
+        radius = std::max(radius, glm::length(vertex.position - center));
+    }
+    m_boundingSphere = glm::vec4(center, radius);
+
+    uploadManager.UploadBuffer(*m_vertexBuffer, 0, vertices.data(), vertices.size_bytes(),
+        VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+    uploadManager.UploadBuffer(*m_indexBuffer, 0, indices.data(), indices.size_bytes(),
+        VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT);
+}
+
+Mesh::~Mesh() = default;
+
+void Mesh::Bind(VkCommandBuffer commandBuffer) const {
+    VkBuffer vertexBuffers[] = { m_vertexBuffer->GetHandle() };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer->GetHandle(), 0, VK_INDEX_TYPE_UINT32);
+}
+
+void Mesh::Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const {
+    vkCmdDrawIndexed(commandBuffer, m_indexCount, instanceCount, 0, 0, firstInstance);
+}
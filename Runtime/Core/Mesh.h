@@ -0,0 +1,53 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 13:00
+* @version: 1.0
+* @description: 顶点/索引缓冲, 数据经 UploadManager 的暂存环形缓冲上传
+********************************************************************************/
+
+#ifndef VULKAN_START_MESH_H
+#define VULKAN_START_MESH_H
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include "Foundation/PreprocessorDirectives.h"
+
+class MemoryAllocator;
+class UploadManager;
+class GpuBuffer;
+
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 color;
+
+    static VkVertexInputBindingDescription GetBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 2> GetAttributeDescriptions();
+};
+
+class Mesh {
+public:
+    Mesh(MemoryAllocator &allocator, UploadManager &uploadManager, std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+    ~Mesh();
+    NON_COPYABLE(Mesh);
+
+    void Bind(VkCommandBuffer commandBuffer) const;
+    void Draw(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+    [[nodiscard]] uint32_t GetIndexCount() const { return m_indexCount; }
+    [[nodiscard]] uint32_t GetVertexCount() const { return m_vertexCount; }
+    // 模型空间包围球, 球心 xyz, 半径 w
+    [[nodiscard]] const glm::vec4 &GetBoundingSphere() const { return m_boundingSphere; }
+
+private:
+    std::unique_ptr<GpuBuffer> m_vertexBuffer;
+    std::unique_ptr<GpuBuffer> m_indexBuffer;
+    uint32_t m_vertexCount = 0;
+    uint32_t m_indexCount = 0;
+    glm::vec4 m_boundingSphere { 0.0f };
+};
+
+
+#endif //VULKAN_START_MESH_H
@@ -0,0 +1,110 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 11:00
+* @version: 1.0
+* @description: 持久化到磁盘的 VkPipelineCache, 启动时加载并校验, 退出时原子写回
+********************************************************************************/
+
+#include "PipelineCache.h"
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include "Foundation/Log.h"
+
+PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, std::filesystem::path path)
+    : m_device(device), m_path(std::move(path)) {
+    vkGetPhysicalDeviceProperties(physicalDevice, &m_properties);
+
+    std::vector<char> data;
+    std::ifstream file(m_path, std::ios::ate | std::ios::binary);
+    if(file.is_open()) {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    // 驱动或设备变化后旧数据无效, 丢弃后从空缓存开始
+    m_loadedFromDisk = !data.empty() && this->validate(data);
+    Log::WarningIf(!data.empty() && !m_loadedFromDisk, "Pipeline cache {} does not match this device, ignoring it.", m_path.string());
+
+    VkPipelineCacheCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext = nullptr,
+        .initialDataSize = m_loadedFromDisk ? data.size() : 0,
+        .pInitialData = m_loadedFromDisk ? data.data() : nullptr,
+    };
+    const auto result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create pipeline cache!");
+    Log::InfoIf(m_loadedFromDisk, "Loaded pipeline cache {} ({} bytes)", m_path.string(), data.size());
+}
+
+PipelineCache::~PipelineCache() {
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+}
+
+/**
+ * 先写临时文件再重命名, 进程中途退出也不会留下半截的缓存文件
+ */
+void PipelineCache::Save() const {
+    size_t size = 0;
+    vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr);
+    std::vector<char> data(size);
+    const auto result = vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data());
+    if(result != VK_SUCCESS || size == 0) {
+        Log::Warning("Failed to read pipeline cache data, cache not saved.");
+        return;
+    }
+
+    auto tempPath = m_path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(size));
+        if(!file.good()) {
+            Log::Warning("Failed to write pipeline cache {}.", tempPath.string());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    Log::WarningIf(static_cast<bool>(error), "Failed to replace pipeline cache {}: {}", m_path.string(), error.message());
+}
+
+/**
+ * 命中信息来自 VK_EXT_pipeline_creation_feedback (1.3 核心), 驱动未填写时退回 CPU 计时且记为未命中
+ * @param name
+ * @param feedback
+ * @param cpuMilliseconds
+ */
+void PipelineCache::RecordCreation(const char *name, const VkPipelineCreationFeedback &feedback, double cpuMilliseconds) {
+    const auto valid = (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT) != 0;
+    const auto hit = valid && (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT) != 0;
+    const auto milliseconds = valid ? static_cast<double>(feedback.duration) / 1e6 : cpuMilliseconds;
+
+    std::lock_guard lock(m_statisticsMutex);
+    hit ? m_hitCount++ : m_missCount++;
+    m_totalMilliseconds += milliseconds;
+    Log::Info("Pipeline {} created in {:.3f} ms (pipeline cache {}, total {} hit / {} miss, {:.3f} ms)",
+        name, milliseconds, hit ? "hit" : "miss", m_hitCount, m_missCount, m_totalMilliseconds);
+}
+
+/**
+ * 校验 VkPipelineCacheHeaderVersionOne 中的版本、厂商、设备和 UUID
+ * @param data
+ * @return
+ */
+bool PipelineCache::validate(const std::vector<char> &data) const {
+    VkPipelineCacheHeaderVersionOne header {};
+    if(data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == m_properties.vendorID &&
+           header.deviceID == m_properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
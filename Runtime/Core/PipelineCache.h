@@ -0,0 +1,45 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 11:00
+* @version: 1.0
+* @description: 持久化到磁盘的 VkPipelineCache, 启动时加载并校验, 退出时原子写回
+********************************************************************************/
+
+#ifndef VULKAN_START_PIPELINECACHE_H
+#define VULKAN_START_PIPELINECACHE_H
+
+#include <filesystem>
+#include <mutex>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+class PipelineCache {
+public:
+    PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, std::filesystem::path path);
+    ~PipelineCache();
+    NON_COPYABLE(PipelineCache);
+
+    [[nodiscard]] VkPipelineCache GetHandle() const { return m_pipelineCache; }
+    [[nodiscard]] bool IsWarm() const { return m_loadedFromDisk; }
+    void Save() const;
+    // 可以在多个编译线程中同时调用
+    void RecordCreation(const char *name, const VkPipelineCreationFeedback &feedback, double cpuMilliseconds);
+
+private:
+    [[nodiscard]] bool validate(const std::vector<char> &data) const;
+
+private:
+    VkDevice m_device = nullptr;
+    VkPhysicalDeviceProperties m_properties {};
+    std::filesystem::path m_path;
+    VkPipelineCache m_pipelineCache = nullptr;
+    bool m_loadedFromDisk = false;
+    std::mutex m_statisticsMutex;
+    uint32_t m_hitCount = 0;
+    uint32_t m_missCount = 0;
+    double m_totalMilliseconds = 0.0;
+};
+
+
+#endif //VULKAN_START_PIPELINECACHE_H
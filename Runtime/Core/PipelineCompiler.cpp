@@ -0,0 +1,458 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 0:00
+* @version: 1.0
+* @description: 异步管线编译: 管线描述提交到工作线程编译, 返回 future; 支持 VK_EXT_graphics_pipeline_library 时
+*               先快速链接预编译的各部分作为过渡管线, 再在后台做链接期优化; 完成的管线在帧边界换入
+********************************************************************************/
+
+#include "PipelineCompiler.h"
+#include <algorithm>
+#include <array>
+#include "Mesh.h"
+#include "PipelineCache.h"
+#include "Foundation/Log.h"
+
+constexpr VkPipelineCreateFlags LIBRARY_CREATE_FLAGS = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+
+namespace {
+
+// 一条图形管线的全部固定功能状态; 结构体之间互相引用, 所以就地构造且不可复制
+struct GraphicsState {
+    VkVertexInputBindingDescription binding = Vertex::GetBindingDescription();
+    std::array<VkVertexInputAttributeDescription, 2> attributes = Vertex::GetAttributeDescriptions();
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    std::array<VkDynamicState, 2> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+    VkPipelineVertexInputStateCreateInfo vertexInput {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .vertexBindingDescriptionCount = 1,
+        .pVertexBindingDescriptions = &binding,
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size()),
+        .pVertexAttributeDescriptions = attributes.data()
+    };
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,                                            // 图元类型
+        .primitiveRestartEnable = VK_FALSE
+    };
+    VkPipelineViewportStateCreateInfo viewport {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .viewportCount = 1,
+        .scissorCount = 1
+    };
+    VkPipelineRasterizationStateCreateInfo rasterization {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .depthClampEnable = VK_FALSE,
+        .rasterizerDiscardEnable = VK_FALSE,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = VK_CULL_MODE_BACK_BIT,
+        .frontFace = VK_FRONT_FACE_CLOCKWISE,
+        .depthBiasEnable = VK_FALSE,
+        .lineWidth = 1.0f
+    };
+    VkPipelineMultisampleStateCreateInfo multisample {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+        .sampleShadingEnable = VK_FALSE
+    };
+    VkPipelineColorBlendAttachmentState colorBlendAttachment {
+        .blendEnable = VK_FALSE,
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+    };
+    VkPipelineColorBlendStateCreateInfo colorBlend {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .logicOpEnable = VK_FALSE,
+        .logicOp = VK_LOGIC_OP_COPY,
+        .attachmentCount = 1,
+        .pAttachments = &colorBlendAttachment,
+        .blendConstants = { 0.0, 0.0, 0.0, 0.0 }
+    };
+    VkPipelineDynamicStateCreateInfo dynamic {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .pNext = nullptr,
+        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+        .pDynamicStates = dynamicStates.data()
+    };
+    // 动态渲染: 管线只声明附件格式, 不再依赖渲染通道对象
+    VkPipelineRenderingCreateInfo rendering {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .pNext = nullptr,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &colorFormat,
+        .depthAttachmentFormat = VK_FORMAT_UNDEFINED,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED
+    };
+
+    explicit GraphicsState(const GraphicsPipelineDesc &desc): colorFormat(desc.colorFormat) {
+        rasterization.cullMode = desc.cullMode;
+        rasterization.frontFace = desc.frontFace;
+    }
+    NON_COPYABLE(GraphicsState);
+};
+
+VkPipelineShaderStageCreateInfo makeStage(VkShaderStageFlagBits stage, VkShaderModule shaderModule) {
+    return {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .stage = stage,
+        .module = shaderModule,
+        .pName = "main",
+    };
+}
+
+}
+
+PipelineCompiler::PipelineCompiler(VkDevice device, PipelineCache &pipelineCache, VkPipelineLayout pipelineLayout, bool usePipelineLibrary, JobSystem &jobSystem)
+    : m_device(device), m_pipelineCache(pipelineCache), m_pipelineLayout(pipelineLayout), m_usePipelineLibrary(usePipelineLibrary), m_jobSystem(jobSystem) {
+    if(m_usePipelineLibrary) {
+        this->createVertexInputLibrary();
+    }
+    Log::Info("Pipeline compiler: graphics pipeline library {}", m_usePipelineLibrary ? "enabled" : "disabled");
+}
+
+/**
+ * 先把提交的任务做完, 链接期优化的任务还持有管线库, 不能直接丢弃; 调用前由外部保证设备空闲
+ */
+PipelineCompiler::~PipelineCompiler() {
+    m_jobSystem.Wait(m_pendingJobs);
+
+    for(const auto &ready : m_readyPipelines) {
+        vkDestroyPipeline(m_device, ready.pipeline, nullptr);
+    }
+    for(const auto &retired : m_retiredPipelines) {
+        vkDestroyPipeline(m_device, retired.pipeline, nullptr);
+    }
+    for(const auto &[format, library] : m_fragmentOutputLibraries) {
+        vkDestroyPipeline(m_device, library, nullptr);
+    }
+    vkDestroyPipeline(m_device, m_vertexInputLibrary, nullptr);
+}
+
+uint32_t PipelineCompiler::RegisterTarget(std::string name, PipelineSwapper swapper) {
+    auto target = std::make_unique<Target>();
+    target->name = std::move(name);
+    target->swapper = std::move(swapper);
+    m_targets.push_back(std::move(target));
+    return static_cast<uint32_t>(m_targets.size() - 1);
+}
+
+PipelineFutures PipelineCompiler::CompileGraphics(uint32_t target, GraphicsPipelineDesc desc) {
+    const auto request = m_targets[target]->nextRequest.fetch_add(1) + 1;
+    auto usable = std::make_shared<std::promise<void>>();
+    auto optimized = std::make_shared<std::promise<void>>();
+    PipelineFutures futures { .usable = usable->get_future().share(), .optimized = optimized->get_future().share() };
+
+    this->enqueue([this, desc = std::move(desc), target, request, usable, optimized]() {
+        if(m_usePipelineLibrary) {
+            this->compileGraphicsLibraries(desc, target, request, usable, optimized);
+        }
+        else {
+            this->compileGraphicsMonolithic(desc, target, request, usable, optimized);
+        }
+    });
+    return futures;
+}
+
+PipelineFutures PipelineCompiler::CompileCompute(uint32_t target, ComputePipelineDesc desc) {
+    const auto request = m_targets[target]->nextRequest.fetch_add(1) + 1;
+    auto promise = std::make_shared<std::promise<void>>();
+    const auto future = promise->get_future().share();
+
+    this->enqueue([this, desc = std::move(desc), target, request, promise]() {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto shaderModule = this->createShaderModule(desc.code);
+        VkPipelineCreationFeedback feedback {};
+        VkPipelineCreationFeedbackCreateInfo feedbackCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+            .pNext = nullptr,
+            .pPipelineCreationFeedback = &feedback,
+            .pipelineStageCreationFeedbackCount = 0,
+        };
+        VkComputePipelineCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .pNext = &feedbackCreateInfo,
+            .stage = makeStage(VK_SHADER_STAGE_COMPUTE_BIT, shaderModule),
+            .layout = m_pipelineLayout,
+        };
+        VkPipeline pipeline = nullptr;
+        const auto result = shaderModule != VK_NULL_HANDLE
+            ? vkCreateComputePipelines(m_device, m_pipelineCache.GetHandle(), 1, &createInfo, nullptr, &pipeline) : VK_ERROR_INITIALIZATION_FAILED;
+        vkDestroyShaderModule(m_device, shaderModule, nullptr);
+
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create {} pipeline!", desc.name);
+        if(result == VK_SUCCESS) {
+            this->recordCreation(desc.name, feedback, startTime);
+            this->publish(target, request, pipeline);
+        }
+        promise->set_value();
+    });
+    return { .usable = future, .optimized = future };
+}
+
+void PipelineCompiler::BeginFrame(uint64_t frameValue, uint64_t completedValue) {
+    std::erase_if(m_retiredPipelines, [&](const RetiredPipeline &retired) {
+        if(completedValue < retired.retireValue) {
+            return false;
+        }
+        vkDestroyPipeline(m_device, retired.pipeline, nullptr);
+        return true;
+    });
+
+    std::vector<ReadyPipeline> readyPipelines;
+    {
+        std::lock_guard lock(m_readyMutex);
+        readyPipelines.swap(m_readyPipelines);
+    }
+    for(const auto &ready : readyPipelines) {
+        auto &target = *m_targets[ready.target];
+        // 同一请求的最终管线晚于过渡管线到达, 可以换入; 更早请求的结果已经过时, 从未被引用, 直接销毁
+        if(ready.request < target.appliedRequest) {
+            vkDestroyPipeline(m_device, ready.pipeline, nullptr);
+            continue;
+        }
+        target.appliedRequest = ready.request;
+        const auto oldPipeline = target.swapper(ready.pipeline);
+        if(oldPipeline != VK_NULL_HANDLE) {
+            m_retiredPipelines.push_back({ .pipeline = oldPipeline, .retireValue = frameValue });
+        }
+    }
+}
+
+void PipelineCompiler::enqueue(std::function<void()> task) {
+    m_jobSystem.Run(std::move(task), &m_pendingJobs, JobPriority::eLow);
+}
+
+void PipelineCompiler::publish(uint32_t target, uint64_t request, VkPipeline pipeline) {
+    std::lock_guard lock(m_readyMutex);
+    m_readyPipelines.push_back({ .target = target, .request = request, .pipeline = pipeline });
+}
+
+/**
+ * 没有管线库时一次创建完整管线, 完成前目标保持原来的管线
+ */
+void PipelineCompiler::compileGraphicsMonolithic(const GraphicsPipelineDesc &desc, uint32_t target, uint64_t request,
+                                                 const std::shared_ptr<std::promise<void>> &usable, const std::shared_ptr<std::promise<void>> &optimized) {
+    const auto startTime = std::chrono::steady_clock::now();
+    GraphicsState state(desc);
+    const auto vertexShaderModule = this->createShaderModule(desc.vertexCode);
+    const auto fragmentShaderModule = this->createShaderModule(desc.fragmentCode);
+    const VkPipelineShaderStageCreateInfo shaderStages[] = {
+        makeStage(VK_SHADER_STAGE_VERTEX_BIT, vertexShaderModule),
+        makeStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragmentShaderModule),
+    };
+
+    VkPipelineCreationFeedback feedback {};
+    VkPipelineCreationFeedbackCreateInfo feedbackCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+        .pNext = nullptr,
+        .pPipelineCreationFeedback = &feedback,
+        .pipelineStageCreationFeedbackCount = 0,
+    };
+    state.rendering.pNext = &feedbackCreateInfo;
+
+    VkGraphicsPipelineCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &state.rendering,
+        .stageCount = 2,
+        .pStages = shaderStages,
+        .pVertexInputState = &state.vertexInput,
+        .pInputAssemblyState = &state.inputAssembly,
+        .pViewportState = &state.viewport,
+        .pRasterizationState = &state.rasterization,
+        .pMultisampleState = &state.multisample,
+        .pColorBlendState = &state.colorBlend,
+        .pDynamicState = &state.dynamic,
+        .layout = m_pipelineLayout,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .basePipelineHandle = VK_NULL_HANDLE
+    };
+    VkPipeline pipeline = nullptr;
+    const auto result = vertexShaderModule != VK_NULL_HANDLE && fragmentShaderModule != VK_NULL_HANDLE
+        ? vkCreateGraphicsPipelines(m_device, m_pipelineCache.GetHandle(), 1, &createInfo, nullptr, &pipeline) : VK_ERROR_INITIALIZATION_FAILED;
+    vkDestroyShaderModule(m_device, vertexShaderModule, nullptr);
+    vkDestroyShaderModule(m_device, fragmentShaderModule, nullptr);
+
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create {} pipeline!", desc.name);
+    if(result == VK_SUCCESS) {
+        this->recordCreation(desc.name, feedback, startTime);
+        this->publish(target, request, pipeline);
+    }
+    usable->set_value();
+    optimized->set_value();
+}
+
+/**
+ * 着色器相关的两部分在这里编译, 与共享的顶点输入和片段输出部分快速链接后立刻可用;
+ * 带链接期优化的最终链接作为单独的任务排队, 不阻塞其他管线的快速链接
+ */
+void PipelineCompiler::compileGraphicsLibraries(const GraphicsPipelineDesc &desc, uint32_t target, uint64_t request,
+                                                const std::shared_ptr<std::promise<void>> &usable, const std::shared_ptr<std::promise<void>> &optimized) {
+    const auto vertexShaderModule = this->createShaderModule(desc.vertexCode);
+    const auto fragmentShaderModule = this->createShaderModule(desc.fragmentCode);
+    const auto vertexStage = makeStage(VK_SHADER_STAGE_VERTEX_BIT, vertexShaderModule);
+    const auto fragmentStage = makeStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragmentShaderModule);
+
+    LibraryParts parts { .fragmentOutput = this->getFragmentOutputLibrary(desc.colorFormat) };
+    if(vertexShaderModule != VK_NULL_HANDLE && fragmentShaderModule != VK_NULL_HANDLE) {
+        parts.preRasterization = this->createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, desc, &vertexStage);
+        parts.fragmentShader = this->createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, desc, &fragmentStage);
+    }
+    // 管线库创建完成后着色器模块就不再需要
+    vkDestroyShaderModule(m_device, vertexShaderModule, nullptr);
+    vkDestroyShaderModule(m_device, fragmentShaderModule, nullptr);
+
+    if(parts.preRasterization == VK_NULL_HANDLE || parts.fragmentShader == VK_NULL_HANDLE || parts.fragmentOutput == VK_NULL_HANDLE) {
+        Log::Error("Failed to create {} pipeline libraries!", desc.name);
+        vkDestroyPipeline(m_device, parts.preRasterization, nullptr);
+        vkDestroyPipeline(m_device, parts.fragmentShader, nullptr);
+        usable->set_value();
+        optimized->set_value();
+        return;
+    }
+
+    const auto fastPipeline = this->linkLibraries(parts, false, desc.name);
+    if(fastPipeline != VK_NULL_HANDLE) {
+        this->publish(target, request, fastPipeline);
+    }
+    usable->set_value();
+
+    this->enqueue([this, parts, target, request, optimized, name = desc.name]() {
+        const auto pipeline = this->linkLibraries(parts, true, name);
+        if(pipeline != VK_NULL_HANDLE) {
+            this->publish(target, request, pipeline);
+        }
+        // 链接得到的管线不依赖管线库的生命周期
+        vkDestroyPipeline(m_device, parts.preRasterization, nullptr);
+        vkDestroyPipeline(m_device, parts.fragmentShader, nullptr);
+        optimized->set_value();
+    });
+}
+
+/**
+ * @param subset 管线库包含的状态子集, 只填写该子集需要的状态
+ * @param stage 着色器子集对应的阶段, 接口子集为空
+ */
+VkPipeline PipelineCompiler::createLibrary(VkGraphicsPipelineLibraryFlagsEXT subset, const GraphicsPipelineDesc &desc, const VkPipelineShaderStageCreateInfo *stage) {
+    GraphicsState state(desc);
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+        .pNext = &state.rendering,
+        .flags = subset,
+    };
+    VkGraphicsPipelineCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &libraryCreateInfo,
+        .flags = LIBRARY_CREATE_FLAGS,
+        .stageCount = stage != nullptr ? 1u : 0u,
+        .pStages = stage,
+    };
+    switch(subset) {
+        case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+            createInfo.pVertexInputState = &state.vertexInput;
+            createInfo.pInputAssemblyState = &state.inputAssembly;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+            createInfo.pViewportState = &state.viewport;
+            createInfo.pRasterizationState = &state.rasterization;
+            createInfo.pDynamicState = &state.dynamic;
+            createInfo.layout = m_pipelineLayout;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+            createInfo.pMultisampleState = &state.multisample;
+            createInfo.layout = m_pipelineLayout;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+            createInfo.pMultisampleState = &state.multisample;
+            createInfo.pColorBlendState = &state.colorBlend;
+            break;
+        default:
+            break;
+    }
+
+    VkPipeline library = nullptr;
+    const auto result = vkCreateGraphicsPipelines(m_device, m_pipelineCache.GetHandle(), 1, &createInfo, nullptr, &library);
+    return result == VK_SUCCESS ? library : VK_NULL_HANDLE;
+}
+
+/**
+ * @param optimize 为 false 时只做快速链接, 得到的过渡管线运行效率可能略低
+ */
+VkPipeline PipelineCompiler::linkLibraries(const LibraryParts &parts, bool optimize, const std::string &name) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const VkPipeline libraries[] = { m_vertexInputLibrary, parts.preRasterization, parts.fragmentShader, parts.fragmentOutput };
+    VkPipelineLibraryCreateInfoKHR libraryCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+        .pNext = nullptr,
+        .libraryCount = static_cast<uint32_t>(std::size(libraries)),
+        .pLibraries = libraries,
+    };
+    VkPipelineCreationFeedback feedback {};
+    VkPipelineCreationFeedbackCreateInfo feedbackCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO,
+        .pNext = &libraryCreateInfo,
+        .pPipelineCreationFeedback = &feedback,
+        .pipelineStageCreationFeedbackCount = 0,
+    };
+    VkGraphicsPipelineCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &feedbackCreateInfo,
+        .flags = optimize ? static_cast<VkPipelineCreateFlags>(VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT) : 0u,
+        .layout = m_pipelineLayout,
+    };
+
+    VkPipeline pipeline = nullptr;
+    const auto result = vkCreateGraphicsPipelines(m_device, m_pipelineCache.GetHandle(), 1, &createInfo, nullptr, &pipeline);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to link {} pipeline!", name);
+    if(result != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    this->recordCreation(optimize ? name : name + " (fast link)", feedback, startTime);
+    return pipeline;
+}
+
+void PipelineCompiler::createVertexInputLibrary() {
+    m_vertexInputLibrary = this->createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, {}, nullptr);
+    if(m_vertexInputLibrary == VK_NULL_HANDLE) {
+        Log::Warning("Failed to create vertex input pipeline library, falling back to monolithic pipelines");
+        m_usePipelineLibrary = false;
+    }
+}
+
+VkPipeline PipelineCompiler::getFragmentOutputLibrary(VkFormat colorFormat) {
+    std::lock_guard lock(m_fragmentOutputMutex);
+    auto &library = m_fragmentOutputLibraries[colorFormat];
+    if(library == VK_NULL_HANDLE) {
+        library = this->createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, { .colorFormat = colorFormat }, nullptr);
+    }
+    return library;
+}
+
+VkShaderModule PipelineCompiler::createShaderModule(const ShaderCode &code) const {
+    if(code.words.empty()) {
+        return VK_NULL_HANDLE;
+    }
+    VkShaderModuleCreateInfo createInfo {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .pNext = nullptr,
+        .codeSize = code.words.size_bytes(),
+        .pCode = code.words.data()
+    };
+    VkShaderModule shaderModule = nullptr;
+    const auto result = vkCreateShaderModule(m_device, &createInfo, nullptr, &shaderModule);
+    return result == VK_SUCCESS ? shaderModule : VK_NULL_HANDLE;
+}
+
+void PipelineCompiler::recordCreation(const std::string &name, const VkPipelineCreationFeedback &feedback, std::chrono::steady_clock::time_point startTime) {
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    m_pipelineCache.RecordCreation(name.c_str(), feedback, elapsed.count());
+}
@@ -0,0 +1,157 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 0:00
+* @version: 1.0
+* @description: 异步管线编译: 管线描述作为低优先级任务提交到任务系统编译, 返回 future; 支持 VK_EXT_graphics_pipeline_library 时
+*               先快速链接预编译的各部分作为过渡管线, 再在后台做链接期优化; 完成的管线在帧边界换入
+********************************************************************************/
+
+#ifndef VULKAN_START_PIPELINECOMPILER_H
+#define VULKAN_START_PIPELINECOMPILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+#include "Foundation/JobSystem.h"
+
+class PipelineCache;
+
+// SPIR-V 字节码: 可以直接指向资源包的映射 (owner 为空), 也可以持有自己的缓冲; 复制描述时不复制字节码
+struct ShaderCode {
+    std::span<const uint32_t> words;
+    std::shared_ptr<const void> owner;
+
+    static ShaderCode Own(std::vector<uint32_t> code) {
+        auto storage = std::make_shared<const std::vector<uint32_t>>(std::move(code));
+        return { .words = *storage, .owner = storage };
+    }
+};
+
+// 图形管线中随材质变化的部分, 顶点格式固定为 Mesh.h 中的 Vertex, 视口和裁剪矩形为动态状态
+struct GraphicsPipelineDesc {
+    std::string name;
+    ShaderCode vertexCode;
+    ShaderCode fragmentCode;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+};
+
+struct ComputePipelineDesc {
+    std::string name;
+    ShaderCode code;
+};
+
+struct PipelineFutures {
+    std::shared_future<void> usable;                            // 已有可以换入的管线 (过渡管线或最终管线)
+    std::shared_future<void> optimized;                         // 最终管线已创建; 没有管线库时与 usable 同时就绪
+};
+
+class PipelineCompiler {
+public:
+    // 在渲染线程的帧边界调用, 换入新管线并返回被换下的旧管线 (可以为空)
+    using PipelineSwapper = std::function<VkPipeline(VkPipeline pipeline)>;
+
+    /**
+     * @param pipelineLayout 所有管线共用的 bindless 管线布局
+     * @param usePipelineLibrary 设备已开启 graphicsPipelineLibrary 特性
+     * @param jobSystem 编译任务以低优先级提交, 不占用帧内任务的等待线程
+     */
+    PipelineCompiler(VkDevice device, PipelineCache &pipelineCache, VkPipelineLayout pipelineLayout, bool usePipelineLibrary, JobSystem &jobSystem);
+    ~PipelineCompiler();
+    NON_COPYABLE(PipelineCompiler);
+
+    // 一个目标对应一个被替换的管线成员, 必须在第一次 Compile 之前在渲染线程注册
+    uint32_t RegisterTarget(std::string name, PipelineSwapper swapper);
+
+    /**
+     * 可以在任意线程调用; 同一目标较早的请求晚于较新的请求完成时, 它的结果直接丢弃
+     */
+    PipelineFutures CompileGraphics(uint32_t target, GraphicsPipelineDesc desc);
+    PipelineFutures CompileCompute(uint32_t target, ComputePipelineDesc desc);
+
+    /**
+     * 每帧录制前在渲染线程调用: 销毁不再被引用的旧管线, 再按完成顺序换入新管线
+     * @param frameValue 本帧图形提交的时间线值, 被换下的管线在它完成后销毁
+     * @param completedValue 图形时间线已完成的值
+     */
+    void BeginFrame(uint64_t frameValue, uint64_t completedValue);
+
+    [[nodiscard]] bool UsesPipelineLibrary() const { return m_usePipelineLibrary; }
+
+private:
+    struct Target {
+        std::string name;
+        PipelineSwapper swapper;
+        std::atomic<uint64_t> nextRequest = 0;
+        uint64_t appliedRequest = 0;                            // 只由渲染线程访问
+    };
+
+    // 快速链接之后等待链接期优化的管线库, 最终链接完成后销毁
+    struct LibraryParts {
+        VkPipeline preRasterization = nullptr;
+        VkPipeline fragmentShader = nullptr;
+        VkPipeline fragmentOutput = nullptr;                    // 按颜色格式共享, 不属于本次请求
+    };
+
+    struct ReadyPipeline {
+        uint32_t target = 0;
+        uint64_t request = 0;
+        VkPipeline pipeline = nullptr;
+    };
+
+    struct RetiredPipeline {
+        VkPipeline pipeline = nullptr;
+        uint64_t retireValue = 0;
+    };
+
+private:
+    void enqueue(std::function<void()> task);
+    void publish(uint32_t target, uint64_t request, VkPipeline pipeline);
+
+    void compileGraphicsMonolithic(const GraphicsPipelineDesc &desc, uint32_t target, uint64_t request,
+                                   const std::shared_ptr<std::promise<void>> &usable, const std::shared_ptr<std::promise<void>> &optimized);
+    void compileGraphicsLibraries(const GraphicsPipelineDesc &desc, uint32_t target, uint64_t request,
+                                  const std::shared_ptr<std::promise<void>> &usable, const std::shared_ptr<std::promise<void>> &optimized);
+    VkPipeline createLibrary(VkGraphicsPipelineLibraryFlagsEXT subset, const GraphicsPipelineDesc &desc, const VkPipelineShaderStageCreateInfo *stage);
+    VkPipeline linkLibraries(const LibraryParts &parts, bool optimize, const std::string &name);
+
+    void createVertexInputLibrary();
+    VkPipeline getFragmentOutputLibrary(VkFormat colorFormat);
+    VkShaderModule createShaderModule(const ShaderCode &code) const;
+    void recordCreation(const std::string &name, const VkPipelineCreationFeedback &feedback, std::chrono::steady_clock::time_point startTime);
+
+private:
+    VkDevice m_device = nullptr;
+    PipelineCache &m_pipelineCache;
+    VkPipelineLayout m_pipelineLayout = nullptr;
+    bool m_usePipelineLibrary = false;
+
+    std::vector<std::unique_ptr<Target>> m_targets;
+
+    // 管线库中不随材质变化的部分: 顶点输入接口全局一份, 片段输出接口按颜色格式各一份
+    VkPipeline m_vertexInputLibrary = nullptr;
+    std::mutex m_fragmentOutputMutex;
+    std::map<VkFormat, VkPipeline> m_fragmentOutputLibraries;
+
+    JobSystem &m_jobSystem;
+    JobCounter m_pendingJobs;                                   // 析构时等待, 链接期优化的任务还持有管线库
+
+    std::mutex m_readyMutex;
+    std::vector<ReadyPipeline> m_readyPipelines;
+    std::vector<RetiredPipeline> m_retiredPipelines;            // 只由渲染线程访问
+};
+
+
+#endif //VULKAN_START_PIPELINECOMPILER_H
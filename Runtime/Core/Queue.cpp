@@ -0,0 +1,173 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 21:00
+* @version: 1.0
+* @description: 设备队列的封装: 记录所属队列族和能力, 提交与呈现加锁, 每次提交递增队列自己的时间线信号量;
+*               以及 EXCLUSIVE 资源跨队列族的所有权转移
+********************************************************************************/
+
+#include "Queue.h"
+#include <vector>
+#include "Foundation/Log.h"
+
+Queue::Queue(VkDevice device, uint32_t familyIndex, VkQueueFlags familyFlags, std::string name)
+    : m_device(device), m_familyIndex(familyIndex), m_familyFlags(familyFlags), m_name(std::move(name)) {
+    vkGetDeviceQueue(device, familyIndex, 0, &m_queue);
+
+    VkSemaphoreTypeCreateInfo typeCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = nullptr,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
+    VkSemaphoreCreateInfo semaphoreCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &typeCreateInfo,
+    };
+    const auto result = vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &m_timeline);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create timeline semaphore for {} queue!", m_name);
+}
+
+Queue::~Queue() {
+    this->WaitIdle();
+    vkDestroySemaphore(m_device, m_timeline, nullptr);
+}
+
+uint64_t Queue::Submit(std::span<const VkCommandBuffer> commandBuffers, std::span<const VkSemaphoreSubmitInfo> waitSemaphores,
+                       std::span<const VkSemaphoreSubmitInfo> signalSemaphores) {
+    std::vector<VkCommandBufferSubmitInfo> commandBufferInfos;
+    commandBufferInfos.reserve(commandBuffers.size());
+    for(const auto commandBuffer : commandBuffers) {
+        commandBufferInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+            .commandBuffer = commandBuffer,
+        });
+    }
+
+    std::lock_guard lock(m_mutex);
+    const auto value = m_submittedValue.load(std::memory_order_relaxed) + 1;
+    std::vector<VkSemaphoreSubmitInfo> signalInfos(signalSemaphores.begin(), signalSemaphores.end());
+    signalInfos.push_back({
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = m_timeline,
+        .value = value,
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    });
+    VkSubmitInfo2 submitInfo {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .waitSemaphoreInfoCount = static_cast<uint32_t>(waitSemaphores.size()),
+        .pWaitSemaphoreInfos = waitSemaphores.data(),
+        .commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos.size()),
+        .pCommandBufferInfos = commandBufferInfos.data(),
+        .signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size()),
+        .pSignalSemaphoreInfos = signalInfos.data()
+    };
+    const auto result = vkQueueSubmit2(m_queue, 1, &submitInfo, VK_NULL_HANDLE);
+    if(result != VK_SUCCESS) {
+        // 提交失败时时间线不会到达 value, 不推进已提交的值, 否则 Wait 和 WaitIdle 会永远等待
+        Log::Error("Failed to submit to {} queue: {}", m_name, static_cast<int32_t>(result));
+        return 0;
+    }
+    m_submittedValue.store(value, std::memory_order_release);
+    return value;
+}
+
+VkResult Queue::Present(const VkPresentInfoKHR &presentInfo) {
+    std::lock_guard lock(m_mutex);
+    return vkQueuePresentKHR(m_queue, &presentInfo);
+}
+
+bool Queue::Wait(uint64_t value, uint64_t timeout) const {
+    if(value == 0) {
+        return true;
+    }
+    VkSemaphoreWaitInfo waitInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &m_timeline,
+        .pValues = &value
+    };
+    return vkWaitSemaphores(m_device, &waitInfo, timeout) == VK_SUCCESS;
+}
+
+VkSemaphoreSubmitInfo Queue::MakeWaitInfo(uint64_t value, VkPipelineStageFlags2 stageMask) const {
+    return {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = m_timeline,
+        .value = value,
+        .stageMask = stageMask,
+    };
+}
+
+uint64_t Queue::GetCompletedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(m_device, m_timeline, &value);
+    return value;
+}
+
+VkBufferMemoryBarrier2 BufferOwnershipTransfer::Release(VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess) const {
+    return {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = srcStage,
+        .srcAccessMask = srcAccess,
+        .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+        .dstAccessMask = VK_ACCESS_2_NONE,
+        .srcQueueFamilyIndex = srcFamily,
+        .dstQueueFamilyIndex = dstFamily,
+        .buffer = buffer,
+        .offset = offset,
+        .size = size
+    };
+}
+
+VkBufferMemoryBarrier2 BufferOwnershipTransfer::Acquire(VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) const {
+    return {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+        .srcAccessMask = VK_ACCESS_2_NONE,
+        .dstStageMask = dstStage,
+        .dstAccessMask = dstAccess,
+        .srcQueueFamilyIndex = srcFamily,
+        .dstQueueFamilyIndex = dstFamily,
+        .buffer = buffer,
+        .offset = offset,
+        .size = size
+    };
+}
+
+VkImageMemoryBarrier2 ImageOwnershipTransfer::Release(VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess) const {
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = srcStage,
+        .srcAccessMask = srcAccess,
+        .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+        .dstAccessMask = VK_ACCESS_2_NONE,
+        .oldLayout = oldLayout,
+        .newLayout = newLayout,
+        .srcQueueFamilyIndex = srcFamily,
+        .dstQueueFamilyIndex = dstFamily,
+        .image = image,
+        .subresourceRange = range
+    };
+}
+
+VkImageMemoryBarrier2 ImageOwnershipTransfer::Acquire(VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) const {
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+        .srcAccessMask = VK_ACCESS_2_NONE,
+        .dstStageMask = dstStage,
+        .dstAccessMask = dstAccess,
+        .oldLayout = oldLayout,
+        .newLayout = newLayout,
+        .srcQueueFamilyIndex = srcFamily,
+        .dstQueueFamilyIndex = dstFamily,
+        .image = image,
+        .subresourceRange = range
+    };
+}
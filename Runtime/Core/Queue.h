@@ -0,0 +1,106 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 21:00
+* @version: 1.0
+* @description: 设备队列的封装: 记录所属队列族和能力, 提交与呈现加锁, 每次提交递增队列自己的时间线信号量;
+*               以及 EXCLUSIVE 资源跨队列族的所有权转移
+********************************************************************************/
+
+#ifndef VULKAN_START_QUEUE_H
+#define VULKAN_START_QUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+class Queue {
+public:
+    /**
+     * @param name 用于日志, 例如 "graphics" / "async compute" / "transfer"
+     * @param familyFlags 所属队列族的能力
+     */
+    Queue(VkDevice device, uint32_t familyIndex, VkQueueFlags familyFlags, std::string name);
+    ~Queue();
+    NON_COPYABLE(Queue);
+
+    /**
+     * 一次提交一批命令缓冲, 完成时把时间线信号量推进到返回的值; 同一个 VkQueue 上的提交需要外部同步, 这里用互斥锁保证
+     * @param waitSemaphores 每个等待的阶段必须是本队列族支持的阶段; 等待其他队列的时间线用它们的 MakeWaitInfo
+     * @param signalSemaphores 额外触发的信号量 (例如呈现用的二值信号量), 时间线信号量由这里自动追加
+     * @return 本次提交对应的时间线值; 提交失败 (如设备丢失) 时为 0, 调用方不应等待它
+     */
+    uint64_t Submit(std::span<const VkCommandBuffer> commandBuffers, std::span<const VkSemaphoreSubmitInfo> waitSemaphores,
+                    std::span<const VkSemaphoreSubmitInfo> signalSemaphores);
+    VkResult Present(const VkPresentInfoKHR &presentInfo);
+
+    /**
+     * CPU 等待时间线到达 value, 即该值及之前的全部提交执行完毕; value 为 0 时立即返回
+     * @param timeout 纳秒
+     * @return 超时返回 false
+     */
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+    void WaitIdle() const { this->Wait(this->GetSubmittedValue()); }
+
+    // 其他队列的提交等待本队列的 value 时使用
+    [[nodiscard]] VkSemaphoreSubmitInfo MakeWaitInfo(uint64_t value, VkPipelineStageFlags2 stageMask) const;
+    [[nodiscard]] uint64_t GetSubmittedValue() const { return m_submittedValue.load(std::memory_order_acquire); }
+    [[nodiscard]] uint64_t GetCompletedValue() const;
+    [[nodiscard]] bool IsCompleted(uint64_t value) const { return value <= this->GetCompletedValue(); }
+
+    [[nodiscard]] VkQueue GetHandle() const { return m_queue; }
+    [[nodiscard]] VkSemaphore GetTimelineSemaphore() const { return m_timeline; }
+    [[nodiscard]] uint32_t GetFamilyIndex() const { return m_familyIndex; }
+    [[nodiscard]] VkQueueFlags GetFamilyFlags() const { return m_familyFlags; }
+    [[nodiscard]] const std::string &GetName() const { return m_name; }
+
+private:
+    VkDevice m_device = nullptr;
+    VkQueue m_queue = nullptr;
+    VkSemaphore m_timeline = nullptr;
+    std::atomic<uint64_t> m_submittedValue = 0;                 // 最近一次提交的时间线值, 只在持有 m_mutex 时增加
+    uint32_t m_familyIndex = 0;
+    VkQueueFlags m_familyFlags = 0;
+    std::string m_name;
+    std::mutex m_mutex;
+};
+
+/**
+ * VK_SHARING_MODE_EXCLUSIVE 的缓冲区间从一个队列族转移到另一个: 源队列录制 Release, 目标队列在等待源队列的信号量之后
+ * 录制参数相同的 Acquire. 两个队列族相同时 IsRequired 为 false, 不需要转移, 队列间的信号量本身已经包含内存依赖
+ */
+struct BufferOwnershipTransfer {
+    VkBuffer buffer = nullptr;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = VK_WHOLE_SIZE;
+    uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED;
+
+    [[nodiscard]] bool IsRequired() const { return srcFamily != dstFamily; }
+    // 目标阶段和访问类型对释放操作没有意义, 由 Acquire 定义
+    [[nodiscard]] VkBufferMemoryBarrier2 Release(VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess) const;
+    // 源阶段和访问类型由 Release 定义, 这里为空
+    [[nodiscard]] VkBufferMemoryBarrier2 Acquire(VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) const;
+};
+
+/**
+ * 图像子资源的所有权转移, 与 BufferOwnershipTransfer 用法相同; 布局转换由 Release 和 Acquire 两个屏障共同描述, 只执行一次
+ */
+struct ImageOwnershipTransfer {
+    VkImage image = nullptr;
+    VkImageSubresourceRange range {};
+    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED;
+
+    [[nodiscard]] bool IsRequired() const { return srcFamily != dstFamily; }
+    [[nodiscard]] VkImageMemoryBarrier2 Release(VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess) const;
+    [[nodiscard]] VkImageMemoryBarrier2 Acquire(VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) const;
+};
+
+
+#endif //VULKAN_START_QUEUE_H
@@ -0,0 +1,536 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 16:00
+* @version: 1.0
+* @description: 帧图: pass 声明读写的资源, 由图裁剪无用 pass, 自动插入屏障和布局转换, 生命周期不重叠的瞬态纹理共享内存
+********************************************************************************/
+
+#include "RenderGraph.h"
+#include <algorithm>
+#include <numeric>
+#include "MemoryAllocator.h"
+#include "Queue.h"
+#include "Foundation/Log.h"
+
+constexpr VkAccessFlags2 WRITE_ACCESS_MASK = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+                                            VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+struct UsageInfo {
+    VkImageLayout layout;
+    VkPipelineStageFlags2 stage;
+    VkAccessFlags2 access;
+};
+
+static UsageInfo getUsageInfo(ResourceUsage usage) {
+    switch (usage) {
+    case ResourceUsage::eColorAttachment:
+        return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+    case ResourceUsage::eDepthAttachment:
+        return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+    case ResourceUsage::eSampled:
+        return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_READ_BIT };
+    case ResourceUsage::eStorageRead:
+        return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT };
+    case ResourceUsage::eStorageWrite:
+        return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT };
+    case ResourceUsage::eTransferSrc:
+        return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+    case ResourceUsage::eTransferDst:
+        return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+    case ResourceUsage::eVertexBuffer:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT };
+    case ResourceUsage::eIndexBuffer:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT };
+    case ResourceUsage::eIndirectBuffer:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT };
+    case ResourceUsage::eUniformBuffer:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_2_UNIFORM_READ_BIT };
+    case ResourceUsage::eHostRead:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT };
+    case ResourceUsage::ePresent:
+        return { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+    case ResourceUsage::eNone:
+    default:
+        return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+    }
+}
+
+RenderGraphHandle RenderGraphBuilder::CreateTexture(std::string_view name, const TransientTextureDesc &desc) {
+    m_graph.m_resources.push_back({
+        .name = std::string(name),
+        .aspect = desc.aspect,
+        .desc = desc,
+    });
+    return { static_cast<uint32_t>(m_graph.m_resources.size() - 1) };
+}
+
+void RenderGraphBuilder::Read(RenderGraphHandle resource, ResourceUsage usage) {
+    m_graph.m_passes[m_passIndex].accesses.push_back({ .resource = resource.index, .usage = usage, .write = false });
+}
+
+void RenderGraphBuilder::Write(RenderGraphHandle resource, ResourceUsage usage) {
+    m_graph.m_passes[m_passIndex].accesses.push_back({ .resource = resource.index, .usage = usage, .write = true });
+}
+
+void RenderGraphBuilder::SetSideEffect() {
+    m_graph.m_passes[m_passIndex].sideEffect = true;
+}
+
+RenderGraph::RenderGraph(VkDevice device, MemoryAllocator &allocator, uint32_t queueFamily)
+    : m_device(device), m_allocator(allocator), m_queueFamily(queueFamily) {
+}
+
+RenderGraph::~RenderGraph() {
+    this->destroyRetiredTransients(true);
+    this->destroyTransients(m_transients);
+    m_memorySlots.clear();
+}
+
+void RenderGraph::BeginFrame(uint64_t frameValue, uint64_t completedValue) {
+    m_frameValue = frameValue;
+    m_completedValue = completedValue;
+    m_passes.clear();
+    m_resources.clear();
+    this->destroyRetiredTransients(false);
+}
+
+RenderGraphHandle RenderGraph::ImportTexture(std::string_view name, const ImportedTexture &texture) {
+    m_resources.push_back({
+        .name = std::string(name),
+        .imported = true,
+        .image = texture.image,
+        .imageView = texture.imageView,
+        .aspect = texture.aspect,
+        .initialLayout = texture.initialLayout,
+        .initialStage = texture.initialStage,
+        .finalUsage = texture.finalUsage,
+    });
+    return { static_cast<uint32_t>(m_resources.size() - 1) };
+}
+
+RenderGraphHandle RenderGraph::ImportBuffer(std::string_view name, const ImportedBuffer &buffer) {
+    m_resources.push_back({
+        .name = std::string(name),
+        .imported = true,
+        .isBuffer = true,
+        .buffer = buffer.buffer,
+        .initialStage = buffer.initialStage,
+        .finalUsage = buffer.finalUsage,
+        .acquireFrom = buffer.acquireFrom == m_queueFamily ? VK_QUEUE_FAMILY_IGNORED : buffer.acquireFrom,
+        .releaseTo = buffer.releaseTo == m_queueFamily ? VK_QUEUE_FAMILY_IGNORED : buffer.releaseTo,
+    });
+    return { static_cast<uint32_t>(m_resources.size() - 1) };
+}
+
+/**
+ * setup 立即执行以收集资源声明, execute 在 Execute 时按声明顺序调用
+ * @param name
+ * @param setup
+ * @param execute
+ */
+void RenderGraph::AddPass(std::string_view name, const SetupFunction &setup, ExecuteFunction execute) {
+    m_passes.push_back({ .name = std::string(name), .execute = std::move(execute) });
+    RenderGraphBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+    setup(builder);
+}
+
+void RenderGraph::Compile() {
+    this->cullPasses();
+    this->computeLifetimes();
+
+    // 瞬态纹理的声明和生命周期与上一帧一致时沿用已有的图像和内存
+    std::vector<TransientTexture> requested;
+    for(auto &resource : m_resources) {
+        if(resource.imported || resource.firstPass == UINT32_MAX) continue;
+        resource.transientIndex = static_cast<uint32_t>(requested.size());
+        requested.push_back({
+            .name = resource.name,
+            .desc = resource.desc,
+            .firstPass = resource.firstPass,
+            .lastPass = resource.lastPass,
+        });
+    }
+
+    const auto unchanged = std::equal(requested.begin(), requested.end(), m_transients.begin(), m_transients.end(),
+        [](const TransientTexture &left, const TransientTexture &right) {
+            return left.name == right.name && left.desc == right.desc && left.firstPass == right.firstPass && left.lastPass == right.lastPass;
+        });
+    if(!unchanged) {
+        // 旧的图像可能仍被 in-flight 帧使用, 延迟销毁
+        m_retiredTransients.push_back({
+            .textures = std::move(m_transients),
+            .slots = std::move(m_memorySlots),
+            .retireValue = m_frameValue,
+        });
+        m_transients = std::move(requested);
+        m_memorySlots.clear();
+        this->createTransients();
+    }
+
+    m_states.assign(m_resources.size(), {});
+}
+
+/**
+ * 从后往前遍历: 有副作用, 写入导入资源, 或写入后续保留 pass 所读资源的 pass 被保留
+ */
+void RenderGraph::cullPasses() {
+    std::vector<bool> needed(m_resources.size(), false);
+    for(auto i = m_passes.size(); i-- > 0;) {
+        auto &pass = m_passes[i];
+        bool keep = pass.sideEffect;
+        for(const auto &access : pass.accesses) {
+            if(access.write && (m_resources[access.resource].imported || needed[access.resource])) {
+                keep = true;
+            }
+        }
+
+        pass.culled = !keep;
+        if(pass.culled) {
+            LOG_DEBUG("[RenderGraph] pass {} culled", pass.name);
+            continue;
+        }
+        for(const auto &access : pass.accesses) {
+            if(!access.write) {
+                needed[access.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::computeLifetimes() {
+    for(uint32_t i = 0; i < m_passes.size(); i++) {
+        if(m_passes[i].culled) continue;
+        for(const auto &access : m_passes[i].accesses) {
+            auto &resource = m_resources[access.resource];
+            resource.firstPass = std::min(resource.firstPass, i);
+            resource.lastPass = std::max(resource.lastPass, i);
+        }
+    }
+}
+
+/**
+ * 按首次使用排序, 贪心地把纹理放进生命周期已结束且内存类型兼容的槽位, 优先选择增长最少的槽位
+ */
+void RenderGraph::createTransients() {
+    struct SlotLayout {
+        VkMemoryRequirements requirements {};
+        uint32_t lastPass = 0;
+    };
+    std::vector<SlotLayout> layouts;
+    VkDeviceSize unaliasedSize = 0;
+
+    std::vector<uint32_t> order(m_transients.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t left, uint32_t right) {
+        return m_transients[left].firstPass < m_transients[right].firstPass;
+    });
+
+    for(const auto index : order) {
+        auto &texture = m_transients[index];
+        VkImageCreateInfo imageCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = texture.desc.format,
+            .extent = { texture.desc.extent.width, texture.desc.extent.height, 1 },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = texture.desc.usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+        const auto result = vkCreateImage(m_device, &imageCreateInfo, nullptr, &texture.image);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create transient image {}!", texture.name);
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(m_device, texture.image, &requirements);
+        unaliasedSize += requirements.size;
+
+        auto best = layouts.size();
+        VkDeviceSize bestGrowth = 0;
+        for(size_t slot = 0; slot < layouts.size(); slot++) {
+            const auto &layout = layouts[slot];
+            if(layout.lastPass >= texture.firstPass || (layout.requirements.memoryTypeBits & requirements.memoryTypeBits) == 0) continue;
+            const auto growth = requirements.size > layout.requirements.size ? requirements.size - layout.requirements.size : 0;
+            if(best == layouts.size() || growth < bestGrowth) {
+                best = slot;
+                bestGrowth = growth;
+            }
+        }
+
+        if(best == layouts.size()) {
+            layouts.push_back({ .requirements = requirements, .lastPass = texture.lastPass });
+        }
+        else {
+            auto &layout = layouts[best];
+            layout.requirements.size = std::max(layout.requirements.size, requirements.size);
+            layout.requirements.alignment = std::max(layout.requirements.alignment, requirements.alignment);
+            layout.requirements.memoryTypeBits &= requirements.memoryTypeBits;
+            layout.lastPass = texture.lastPass;
+        }
+        texture.memorySlot = static_cast<uint32_t>(best);
+    }
+
+    VkDeviceSize aliasedSize = 0;
+    m_memorySlots.resize(layouts.size());
+    for(size_t slot = 0; slot < layouts.size(); slot++) {
+        m_memorySlots[slot].memory = m_allocator.AllocateMemory(layouts[slot].requirements);
+        aliasedSize += layouts[slot].requirements.size;
+    }
+
+    for(auto &texture : m_transients) {
+        m_memorySlots[texture.memorySlot].memory->BindImage(texture.image);
+
+        VkImageViewCreateInfo imageViewCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = texture.image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = texture.desc.format,
+            .subresourceRange = {
+                .aspectMask = texture.desc.aspect,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        };
+        const auto result = vkCreateImageView(m_device, &imageViewCreateInfo, nullptr, &texture.imageView);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create transient image view {}!", texture.name);
+    }
+
+    Log::InfoIf(!m_transients.empty(), "[RenderGraph] {} transient textures aliased into {} memory blocks: {:.1f} MB (unaliased {:.1f} MB)",
+        m_transients.size(), m_memorySlots.size(), aliasedSize / (1024.0 * 1024.0), unaliasedSize / (1024.0 * 1024.0));
+}
+
+void RenderGraph::destroyTransients(std::vector<TransientTexture> &textures) {
+    for(const auto &texture : textures) {
+        vkDestroyImageView(m_device, texture.imageView, nullptr);
+        vkDestroyImage(m_device, texture.image, nullptr);
+    }
+    textures.clear();
+}
+
+void RenderGraph::destroyRetiredTransients(bool force) {
+    std::erase_if(m_retiredTransients, [&](RetiredTransients &retired) {
+        if(!force && m_completedValue < retired.retireValue) {
+            return false;
+        }
+        this->destroyTransients(retired.textures);
+        retired.slots.clear();
+        return true;
+    });
+}
+
+/**
+ * 根据资源当前状态和新的用途生成屏障: 写入前等待此前所有读写, 读取前只在上次写入尚未对该阶段可见或布局变化时同步
+ * @param resourceIndex
+ * @param usage
+ * @param write
+ * @param batch 同一个 pass 的屏障合并为一次 vkCmdPipelineBarrier2, 每个屏障各自携带阶段
+ */
+void RenderGraph::transition(uint32_t resourceIndex, ResourceUsage usage, bool write, BarrierBatch &batch) {
+    const auto &resource = m_resources[resourceIndex];
+    auto &state = m_states[resourceIndex];
+    if(!state.initialized) {
+        state.initialized = true;
+        if(resource.imported) {
+            state.layout = resource.initialLayout;
+            state.writeStage = resource.initialStage;
+        }
+        else {
+            // 瞬态纹理不保留内容, 只需等待同一内存槽位上一个使用者 (本帧更早的别名资源或上一帧) 的访问结束
+            const auto &slot = m_memorySlots[m_transients[resource.transientIndex].memorySlot];
+            state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            state.writeStage = slot.lastStage;
+            state.writeAccess = slot.lastAccess;
+        }
+    }
+
+    const auto info = getUsageInfo(usage);
+    if(resource.acquireFrom != VK_QUEUE_FAMILY_IGNORED && !state.acquired) {
+        // 获取操作兼作首次使用的屏障, 源队列的写入通过释放操作和信号量对这里可见
+        const BufferOwnershipTransfer transfer {
+            .buffer = resource.buffer,
+            .srcFamily = resource.acquireFrom,
+            .dstFamily = m_queueFamily,
+        };
+        batch.bufferBarriers.push_back(transfer.Acquire(info.stage, info.access));
+        state.acquired = true;
+        state.writeStage = info.stage;
+        state.writeAccess = write ? info.access & WRITE_ACCESS_MASK : VK_ACCESS_2_NONE;
+        state.readStages = write ? 0 : info.stage;
+        state.visibleStages = info.stage;
+        return;
+    }
+
+    const auto layoutChanged = !resource.isBuffer && state.layout != info.layout;
+    bool needBarrier = false;
+    VkPipelineStageFlags2 srcStage = VK_PIPELINE_STAGE_2_NONE;
+    if(write) {
+        needBarrier = layoutChanged || state.writeStage != 0 || state.readStages != 0;
+        srcStage = state.writeStage | state.readStages;
+    }
+    else {
+        needBarrier = layoutChanged || (state.writeAccess != 0 && (state.visibleStages & info.stage) != info.stage);
+        srcStage = state.writeStage | (layoutChanged ? state.readStages : 0);
+    }
+
+    if(needBarrier) {
+        if(resource.isBuffer) {
+            batch.bufferBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .pNext = nullptr,
+                .srcStageMask = srcStage,
+                .srcAccessMask = state.writeAccess,
+                .dstStageMask = info.stage,
+                .dstAccessMask = info.access,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = resource.buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE
+            });
+        }
+        else {
+            batch.imageBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .pNext = nullptr,
+                .srcStageMask = srcStage,
+                .srcAccessMask = state.writeAccess,
+                .dstStageMask = info.stage,
+                .dstAccessMask = info.access,
+                .oldLayout = state.layout,
+                .newLayout = info.layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = this->GetImage({ resourceIndex }),
+                .subresourceRange = {
+                    .aspectMask = resource.aspect,
+                    .baseMipLevel = 0,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS
+                }
+            });
+        }
+    }
+
+    if(write) {
+        state.writeStage = info.stage;
+        state.writeAccess = info.access & WRITE_ACCESS_MASK;
+        state.readStages = 0;
+        state.visibleStages = 0;
+    }
+    else if(layoutChanged) {
+        // 布局转换本身是一次写入, 之后只对本次的阶段可见
+        state.writeStage = info.stage;
+        state.writeAccess = VK_ACCESS_2_NONE;
+        state.readStages = info.stage;
+        state.visibleStages = info.stage;
+    }
+    else {
+        state.readStages |= info.stage;
+        state.visibleStages |= info.stage;
+    }
+    if(!resource.isBuffer) {
+        state.layout = info.layout;
+    }
+}
+
+/**
+ * 把导入缓冲的所有权交给 releaseTo 队列族; 释放前的写入和读取都要完成, 目标阶段由对方的获取操作定义
+ * @param resourceIndex
+ * @param batch
+ */
+void RenderGraph::release(uint32_t resourceIndex, BarrierBatch &batch) const {
+    const auto &resource = m_resources[resourceIndex];
+    const auto &state = m_states[resourceIndex];
+    const BufferOwnershipTransfer transfer {
+        .buffer = resource.buffer,
+        .srcFamily = m_queueFamily,
+        .dstFamily = resource.releaseTo,
+    };
+    batch.bufferBarriers.push_back(transfer.Release(state.writeStage | state.readStages, state.writeAccess));
+}
+
+void RenderGraph::flushBarriers(VkCommandBuffer commandBuffer, BarrierBatch &batch) const {
+    if(batch.imageBarriers.empty() && batch.bufferBarriers.empty()) {
+        return;
+    }
+    VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = static_cast<uint32_t>(batch.bufferBarriers.size()),
+        .pBufferMemoryBarriers = batch.bufferBarriers.data(),
+        .imageMemoryBarrierCount = static_cast<uint32_t>(batch.imageBarriers.size()),
+        .pImageMemoryBarriers = batch.imageBarriers.data(),
+    };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    batch.bufferBarriers.clear();
+    batch.imageBarriers.clear();
+}
+
+void RenderGraph::Execute(VkCommandBuffer commandBuffer) {
+    BarrierBatch batch;
+    for(auto &pass : m_passes) {
+        if(pass.culled) continue;
+
+        for(const auto &access : pass.accesses) {
+            this->transition(access.resource, access.usage, access.write, batch);
+        }
+        this->flushBarriers(commandBuffer, batch);
+
+        pass.execute(commandBuffer);
+
+        // 记录内存槽位最后的访问, 别名到同一槽位的下一个纹理 (或下一帧) 据此同步
+        for(const auto &access : pass.accesses) {
+            const auto &resource = m_resources[access.resource];
+            if(resource.imported) continue;
+            const auto &state = m_states[access.resource];
+            auto &slot = m_memorySlots[m_transients[resource.transientIndex].memorySlot];
+            slot.lastStage = state.writeStage | state.readStages;
+            slot.lastAccess = state.writeAccess;
+        }
+    }
+
+    for(uint32_t i = 0; i < m_resources.size(); i++) {
+        const auto &resource = m_resources[i];
+        if(!resource.imported || !m_states[i].initialized) continue;
+        // 同一批屏障之间没有顺序, 释放所有权时不再做最终转换, 由获取方决定用途
+        if(resource.releaseTo != VK_QUEUE_FAMILY_IGNORED) {
+            this->release(i, batch);
+        }
+        else if(resource.finalUsage != ResourceUsage::eNone) {
+            this->transition(i, resource.finalUsage, false, batch);
+        }
+    }
+    this->flushBarriers(commandBuffer, batch);
+}
+
+VkImage RenderGraph::GetImage(RenderGraphHandle resource) const {
+    const auto &entry = m_resources[resource.index];
+    return entry.imported ? entry.image : m_transients[entry.transientIndex].image;
+}
+
+VkImageView RenderGraph::GetImageView(RenderGraphHandle resource) const {
+    const auto &entry = m_resources[resource.index];
+    return entry.imported ? entry.imageView : m_transients[entry.transientIndex].imageView;
+}
+
+VkBuffer RenderGraph::GetBuffer(RenderGraphHandle resource) const {
+    return m_resources[resource.index].buffer;
+}
+
+VkDeviceSize RenderGraph::GetTransientMemorySize() const {
+    VkDeviceSize size = 0;
+    for(const auto &slot : m_memorySlots) {
+        size += slot.memory != nullptr ? slot.memory->GetSize() : 0;
+    }
+    return size;
+}
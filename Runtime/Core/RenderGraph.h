@@ -0,0 +1,229 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 16:00
+* @version: 1.0
+* @description: 帧图: pass 声明读写的资源, 由图裁剪无用 pass, 自动插入屏障和布局转换, 生命周期不重叠的瞬态纹理共享内存
+********************************************************************************/
+
+#ifndef VULKAN_START_RENDERGRAPH_H
+#define VULKAN_START_RENDERGRAPH_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+class MemoryAllocator;
+class GpuMemoryBlock;
+class RenderGraph;
+
+// 资源在一个 pass 中的用途, 决定图像布局, 管线阶段和访问类型
+enum class ResourceUsage {
+    eNone,
+    eColorAttachment,
+    eDepthAttachment,
+    eSampled,
+    eStorageRead,
+    eStorageWrite,
+    eTransferSrc,
+    eTransferDst,
+    eVertexBuffer,
+    eIndexBuffer,
+    eIndirectBuffer,
+    eUniformBuffer,
+    eHostRead,
+    ePresent,
+};
+
+// 只在创建它的那一帧内有效
+struct RenderGraphHandle {
+    uint32_t index = UINT32_MAX;
+    [[nodiscard]] bool IsValid() const { return index != UINT32_MAX; }
+};
+
+struct TransientTextureDesc {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = { 0, 0 };
+    VkImageUsageFlags usage = 0;
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+
+    bool operator==(const TransientTextureDesc &other) const {
+        return format == other.format && extent.width == other.extent.width && extent.height == other.extent.height &&
+               usage == other.usage && aspect == other.aspect;
+    }
+};
+
+// 由图外部创建和持有的纹理, 例如交换链图像
+struct ImportedTexture {
+    VkImage image = nullptr;
+    VkImageView imageView = nullptr;
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE;          // 图之前最后访问它的阶段, 或等待信号量的阶段
+    ResourceUsage finalUsage = ResourceUsage::eNone;                        // 图结束时转换到该用途, eNone 表示保持原样
+};
+
+// 由其他队列族写入或读取时, 图在首次使用前获取所有权, 在结束时释放所有权; 与图所在队列族相同时忽略
+struct ImportedBuffer {
+    VkBuffer buffer = nullptr;
+    VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE;
+    ResourceUsage finalUsage = ResourceUsage::eNone;
+    uint32_t acquireFrom = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t releaseTo = VK_QUEUE_FAMILY_IGNORED;
+};
+
+class RenderGraphBuilder {
+public:
+    RenderGraphHandle CreateTexture(std::string_view name, const TransientTextureDesc &desc);
+    void Read(RenderGraphHandle resource, ResourceUsage usage);
+    void Write(RenderGraphHandle resource, ResourceUsage usage);
+    // 输出不在图内 (如读回到主机) 的 pass 需要标记, 否则会被裁剪
+    void SetSideEffect();
+
+private:
+    friend class RenderGraph;
+    RenderGraphBuilder(RenderGraph &graph, uint32_t passIndex) : m_graph(graph), m_passIndex(passIndex) {}
+
+private:
+    RenderGraph &m_graph;
+    uint32_t m_passIndex = 0;
+};
+
+class RenderGraph {
+public:
+    using SetupFunction = std::function<void(RenderGraphBuilder &)>;
+    using ExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+    /**
+     * @param queueFamily 执行该图的命令缓冲所属的队列族, 用于跨队列族的所有权转移
+     */
+    RenderGraph(VkDevice device, MemoryAllocator &allocator, uint32_t queueFamily);
+    ~RenderGraph();
+    NON_COPYABLE(RenderGraph);
+
+    /**
+     * 每帧重新声明 pass 和资源; 瞬态纹理在声明不变时跨帧复用
+     * @param frameValue 本帧提交完成时的时间线值, 本帧退役的瞬态纹理在该值完成后销毁
+     * @param completedValue 同一时间线上已经完成的值
+     */
+    void BeginFrame(uint64_t frameValue, uint64_t completedValue);
+    RenderGraphHandle ImportTexture(std::string_view name, const ImportedTexture &texture);
+    RenderGraphHandle ImportBuffer(std::string_view name, const ImportedBuffer &buffer);
+    void AddPass(std::string_view name, const SetupFunction &setup, ExecuteFunction execute);
+    void Compile();
+    void Execute(VkCommandBuffer commandBuffer);
+
+    [[nodiscard]] VkImage GetImage(RenderGraphHandle resource) const;
+    [[nodiscard]] VkImageView GetImageView(RenderGraphHandle resource) const;
+    [[nodiscard]] VkBuffer GetBuffer(RenderGraphHandle resource) const;
+    [[nodiscard]] VkDeviceSize GetTransientMemorySize() const;
+    [[nodiscard]] uint32_t GetQueueFamily() const { return m_queueFamily; }
+
+private:
+    friend class RenderGraphBuilder;
+
+    struct ResourceAccess {
+        uint32_t resource = 0;
+        ResourceUsage usage = ResourceUsage::eNone;
+        bool write = false;
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFunction execute;
+        std::vector<ResourceAccess> accesses;
+        bool sideEffect = false;
+        bool culled = false;
+    };
+
+    struct Resource {
+        std::string name;
+        bool imported = false;
+        bool isBuffer = false;
+        VkImage image = nullptr;
+        VkImageView imageView = nullptr;
+        VkBuffer buffer = nullptr;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE;
+        ResourceUsage finalUsage = ResourceUsage::eNone;
+        uint32_t acquireFrom = VK_QUEUE_FAMILY_IGNORED;
+        uint32_t releaseTo = VK_QUEUE_FAMILY_IGNORED;
+        TransientTextureDesc desc;
+        uint32_t firstPass = UINT32_MAX;
+        uint32_t lastPass = 0;
+        uint32_t transientIndex = UINT32_MAX;
+    };
+
+    // 跨帧保留的瞬态纹理, 声明 (名称, 描述, 生命周期) 不变时直接复用
+    struct TransientTexture {
+        std::string name;
+        TransientTextureDesc desc;
+        uint32_t firstPass = 0;
+        uint32_t lastPass = 0;
+        VkImage image = nullptr;
+        VkImageView imageView = nullptr;
+        uint32_t memorySlot = 0;
+    };
+
+    // 一块被若干瞬态纹理别名共享的内存, 记录最后一次访问以便下一个使用者与其同步
+    struct MemorySlot {
+        std::unique_ptr<GpuMemoryBlock> memory;
+        VkPipelineStageFlags2 lastStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 lastAccess = VK_ACCESS_2_NONE;
+    };
+
+    struct ResourceState {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 writeStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+        VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;     // 上次写入后的读取阶段, 下一次写入前需要等待它们
+        VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE;  // 上次写入已经对这些阶段可见
+        bool initialized = false;
+        bool acquired = false;
+    };
+
+    struct BarrierBatch {
+        std::vector<VkImageMemoryBarrier2> imageBarriers;
+        std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+    };
+
+    struct RetiredTransients {
+        std::vector<TransientTexture> textures;
+        std::vector<MemorySlot> slots;
+        uint64_t retireValue = 0;
+    };
+
+private:
+    void cullPasses();
+    void computeLifetimes();
+    void createTransients();
+    void destroyTransients(std::vector<TransientTexture> &textures);
+    void destroyRetiredTransients(bool force);
+    void transition(uint32_t resourceIndex, ResourceUsage usage, bool write, BarrierBatch &batch);
+    void release(uint32_t resourceIndex, BarrierBatch &batch) const;
+    void flushBarriers(VkCommandBuffer commandBuffer, BarrierBatch &batch) const;
+
+private:
+    VkDevice m_device = nullptr;
+    MemoryAllocator &m_allocator;
+    uint32_t m_queueFamily = 0;
+    uint64_t m_frameValue = 0;
+    uint64_t m_completedValue = 0;
+
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    std::vector<ResourceState> m_states;
+
+    std::vector<TransientTexture> m_transients;
+    std::vector<MemorySlot> m_memorySlots;
+    std::vector<RetiredTransients> m_retiredTransients;
+};
+
+
+#endif //VULKAN_START_RENDERGRAPH_H
@@ -0,0 +1,26 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 3:00
+* @version: 1.0
+* @description: 主线程交给渲染线程的一帧快照: 主线程处理事件和逻辑时写入, 渲染线程只读取快照而不访问窗口和逻辑状态
+********************************************************************************/
+
+#ifndef VULKAN_START_RENDERPACKET_H
+#define VULKAN_START_RENDERPACKET_H
+
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "../BaseDefine.h"
+
+struct RenderPacket {
+    uint64_t frame = 0;                                         // 主线程的逻辑帧号
+    std::chrono::steady_clock::time_point inputTime;            // 本帧处理输入的时刻, 输入到显示的延迟从这里开始计算
+    Size framebufferSize {};                                    // GLFW 只能在主线程查询, 交换链重建使用这里的大小
+    bool resized = false;                                       // 上一个快照之后窗口大小改变过
+    glm::mat4 viewProjection { 1.0f };
+};
+
+
+#endif //VULKAN_START_RENDERPACKET_H
@@ -0,0 +1,119 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 23:00
+* @version: 1.0
+* @description: 运行时把 GLSL 编译为 SPIR-V (shaderc), 支持 #include 并记录被包含的文件
+********************************************************************************/
+
+#include "ShaderCompiler.h"
+#include <fstream>
+#include <sstream>
+#include <shaderc/shaderc.hpp>
+
+namespace {
+
+std::optional<std::string> readText(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) {
+        return std::nullopt;
+    }
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+// 被包含文件的名字和内容必须在 ReleaseInclude 之前保持有效, 与 shaderc_include_result 一起分配
+struct IncludeData {
+    shaderc_include_result result {};
+    std::string sourceName;
+    std::string content;
+};
+
+class Includer final : public shaderc::CompileOptions::IncluderInterface {
+public:
+    explicit Includer(std::vector<std::filesystem::path> &includes): m_includes(includes) {}
+
+    shaderc_include_result *GetInclude(const char *requestedSource, shaderc_include_type type, const char *requestingSource, size_t includeDepth) override {
+        UNUSED_VAR(type);
+        UNUSED_VAR(includeDepth);
+        auto *data = new IncludeData;
+        const auto path = (std::filesystem::path(requestingSource).parent_path() / requestedSource).lexically_normal();
+        if(auto content = readText(path)) {
+            data->sourceName = path.string();
+            data->content = std::move(*content);
+            m_includes.push_back(path);
+        }
+        else {
+            // 名字为空表示失败, content 作为错误信息
+            data->content = "cannot open " + path.string();
+        }
+        data->result = {
+            .source_name = data->sourceName.c_str(),
+            .source_name_length = data->sourceName.size(),
+            .content = data->content.c_str(),
+            .content_length = data->content.size(),
+            .user_data = data,
+        };
+        return &data->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result *result) override {
+        delete static_cast<IncludeData *>(result->user_data);
+    }
+
+private:
+    std::vector<std::filesystem::path> &m_includes;
+};
+
+}
+
+ShaderCompiler::ShaderCompiler(): m_compiler(std::make_unique<shaderc::Compiler>()) {
+}
+
+ShaderCompiler::~ShaderCompiler() = default;
+
+ShaderCompileResult ShaderCompiler::CompileFile(const std::filesystem::path &path) const {
+    ShaderCompileResult result;
+    const auto stage = ShaderCompiler::GetStage(path);
+    const auto source = readText(path);
+    if(!stage.has_value() || !source.has_value()) {
+        result.message = "cannot open " + path.string();
+        return result;
+    }
+
+    shaderc_shader_kind kind = shaderc_glsl_vertex_shader;
+    switch(*stage) {
+        case VK_SHADER_STAGE_FRAGMENT_BIT: kind = shaderc_glsl_fragment_shader; break;
+        case VK_SHADER_STAGE_COMPUTE_BIT: kind = shaderc_glsl_compute_shader; break;
+        default: break;
+    }
+
+    shaderc::CompileOptions options;
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+    options.SetIncluder(std::make_unique<Includer>(result.includes));
+#ifndef MODE_DEBUG
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+#endif
+
+    const auto compiled = m_compiler->CompileGlslToSpv(*source, kind, path.string().c_str(), options);
+    result.message = compiled.GetErrorMessage();
+    if(compiled.GetCompilationStatus() == shaderc_compilation_status_success) {
+        result.spirv.assign(compiled.cbegin(), compiled.cend());
+    }
+    return result;
+}
+
+std::optional<VkShaderStageFlagBits> ShaderCompiler::GetStage(const std::filesystem::path &path) {
+    const auto extension = path.extension();
+    if(extension == ".vert") {
+        return VK_SHADER_STAGE_VERTEX_BIT;
+    }
+    if(extension == ".frag") {
+        return VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    if(extension == ".comp") {
+        return VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,53 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 23:00
+* @version: 1.0
+* @description: 运行时把 GLSL 编译为 SPIR-V (shaderc), 支持 #include 并记录被包含的文件
+********************************************************************************/
+
+#ifndef VULKAN_START_SHADERCOMPILER_H
+#define VULKAN_START_SHADERCOMPILER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+namespace shaderc {
+class Compiler;
+}
+
+struct ShaderCompileResult {
+    std::vector<uint32_t> spirv;                                // 失败时为空
+    std::string message;                                        // 编译器输出的错误和警告
+    std::vector<std::filesystem::path> includes;                // 本次编译打开过的所有被包含文件
+
+    [[nodiscard]] bool IsSuccess() const { return !spirv.empty(); }
+};
+
+class ShaderCompiler {
+public:
+    ShaderCompiler();
+    ~ShaderCompiler();
+    NON_COPYABLE(ShaderCompiler);
+
+    /**
+     * 按扩展名确定着色器阶段, 可以在多个线程中同时调用
+     * @param path .vert / .frag / .comp; #include "x" 相对于包含它的文件解析
+     */
+    [[nodiscard]] ShaderCompileResult CompileFile(const std::filesystem::path &path) const;
+
+    // 不是着色器入口文件 (例如被包含的 .glsl) 时返回空
+    static std::optional<VkShaderStageFlagBits> GetStage(const std::filesystem::path &path);
+
+private:
+    std::unique_ptr<shaderc::Compiler> m_compiler;
+};
+
+
+#endif //VULKAN_START_SHADERCOMPILER_H
@@ -0,0 +1,166 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 23:00
+* @version: 1.0
+* @description: 着色器热重载: 在 JobSystem 的 I/O 线程上监视着色器源码目录, 文件变化后重新编译受影响的着色器, 把 SPIR-V 交给回调;
+*               管线的重建和换入由 PipelineCompiler 负责
+********************************************************************************/
+
+#include "ShaderHotReload.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "Foundation/Log.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+constexpr int WATCH_POLL_MS = 100;                              // 每次监视任务最多阻塞这么久, 也是没有 inotify 时的轮询间隔
+constexpr int DEBOUNCE_MS = 50;                                 // 编辑器保存一次可能产生多个事件, 静默这么久才开始编译
+
+ShaderHotReload::ShaderHotReload(std::filesystem::path shaderDirectory, JobSystem &jobSystem)
+    : m_directory(std::filesystem::absolute(shaderDirectory).lexically_normal()), m_jobSystem(jobSystem) {
+}
+
+ShaderHotReload::~ShaderHotReload() {
+    m_stopping = true;
+    m_jobSystem.Wait(m_watchCounter);
+#ifdef __linux__
+    if(m_watchHandle >= 0) {
+        close(m_watchHandle);
+    }
+#endif
+}
+
+void ShaderHotReload::Register(std::string name, std::vector<std::filesystem::path> sources, ReloadCallback callback) {
+    for(auto &source : sources) {
+        source = m_directory / source;
+    }
+    m_entries.push_back({
+        .name = std::move(name),
+        .sources = std::move(sources),
+        .callback = std::move(callback),
+    });
+}
+
+void ShaderHotReload::Start() {
+#ifdef __linux__
+    m_watchHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_watchHandle < 0 || inotify_add_watch(m_watchHandle, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        Log::Warning("[ShaderHotReload] failed to watch {}, hot reload disabled", m_directory.string());
+        return;
+    }
+#else
+    std::error_code error;
+    for(const auto &file : std::filesystem::directory_iterator(m_directory, error)) {
+        m_writeTimes[file.path()] = file.last_write_time(error);
+    }
+#endif
+    m_jobSystem.RunIo([this] {
+        // 先编译一遍得到各入口文件包含了哪些文件, 之后只重建依赖了变化文件的管线
+        for(auto &entry : m_entries) {
+            this->scanDependencies(entry);
+        }
+        this->watch();
+    }, &m_watchCounter);
+    Log::Info("[ShaderHotReload] watching {}", m_directory.string());
+}
+
+/**
+ * 一次监视任务: 检查一次目录变化, 变化静默 DEBOUNCE_MS 后重建受影响的着色器, 然后重新提交自己.
+ * 每次最多阻塞 WATCH_POLL_MS, 之后排到 I/O 队列末尾, 不会让纹理读取等太久;
+ * 一个 I/O 线程大部分时间停在 poll 上, 开启热重载时 Application 为此多创建一个 I/O 线程
+ */
+void ShaderHotReload::watch() {
+    if(!this->pollChanges(m_changed.empty() ? WATCH_POLL_MS : DEBOUNCE_MS) && !m_changed.empty()) {
+        for(size_t i = 0; i < m_entries.size() && !m_stopping; i++) {
+            const auto &dependencies = m_entries[i].dependencies;
+            if(std::ranges::any_of(m_changed, [&](const auto &path) { return dependencies.contains(path); })) {
+                this->rebuild(i);
+            }
+        }
+        m_changed.clear();
+    }
+
+    if(!m_stopping) {
+        m_jobSystem.RunIo([this] { this->watch(); }, &m_watchCounter);
+    }
+}
+
+/**
+ * 最多等待 timeoutMs, 把期间被写入或移入的文件的绝对路径加入 m_changed
+ * @return 是否有新的变化
+ */
+bool ShaderHotReload::pollChanges(int timeoutMs) {
+    auto found = false;
+#ifdef __linux__
+    pollfd pollDescriptor { .fd = m_watchHandle, .events = POLLIN, .revents = 0 };
+    if(poll(&pollDescriptor, 1, timeoutMs) <= 0) {
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    const auto length = read(m_watchHandle, buffer, sizeof(buffer));
+    for(ssize_t offset = 0; offset < length;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        if(event->len > 0) {
+            m_changed.insert(m_directory / event->name);
+            found = true;
+        }
+        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+    }
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+    std::error_code error;
+    for(const auto &file : std::filesystem::directory_iterator(m_directory, error)) {
+        const auto writeTime = file.last_write_time(error);
+        auto &knownTime = m_writeTimes[file.path()];
+        if(!error && knownTime != writeTime) {
+            knownTime = writeTime;
+            m_changed.insert(file.path());
+            found = true;
+        }
+    }
+#endif
+    return found;
+}
+
+void ShaderHotReload::scanDependencies(Entry &entry) {
+    entry.dependencies.insert(entry.sources.begin(), entry.sources.end());
+    for(const auto &source : entry.sources) {
+        const auto result = m_compiler.CompileFile(source);
+        entry.dependencies.insert(result.includes.begin(), result.includes.end());
+    }
+}
+
+/**
+ * 编译失败时保留当前管线, 修正源码再保存即可重试
+ */
+void ShaderHotReload::rebuild(size_t entryIndex) {
+    auto &entry = m_entries[entryIndex];
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::set<std::filesystem::path> dependencies(entry.sources.begin(), entry.sources.end());
+    std::vector<std::vector<uint32_t>> spirv;
+    for(const auto &source : entry.sources) {
+        auto result = m_compiler.CompileFile(source);
+        dependencies.insert(result.includes.begin(), result.includes.end());
+        if(!result.IsSuccess()) {
+            // 失败时包含关系可能不完整, 与旧的合并, 以免漏掉之后的修改
+            entry.dependencies.merge(dependencies);
+            Log::Warning("[ShaderHotReload] {} failed to compile, keeping the current {} pipeline:\n{}",
+                source.filename().string(), entry.name, result.message);
+            return;
+        }
+        spirv.push_back(std::move(result.spirv));
+    }
+    entry.dependencies = std::move(dependencies);
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    Log::Info("[ShaderHotReload] recompiled {} shaders in {:.1f} ms", entry.name, elapsed.count());
+    entry.callback(std::move(spirv));
+}
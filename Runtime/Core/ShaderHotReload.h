@@ -0,0 +1,68 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 23:00
+* @version: 1.0
+* @description: 着色器热重载: 在 JobSystem 的 I/O 线程上监视着色器源码目录, 文件变化后重新编译受影响的着色器, 把 SPIR-V 交给回调;
+*               管线的重建和换入由 PipelineCompiler 负责
+********************************************************************************/
+
+#ifndef VULKAN_START_SHADERHOTRELOAD_H
+#define VULKAN_START_SHADERHOTRELOAD_H
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "ShaderCompiler.h"
+#include "Foundation/JobSystem.h"
+#include "Foundation/PreprocessorDirectives.h"
+
+class ShaderHotReload {
+public:
+    // 在 I/O 线程调用, SPIR-V 按注册时 sources 的顺序传入; 只有全部源码编译成功时才调用
+    using ReloadCallback = std::function<void(std::vector<std::vector<uint32_t>> spirv)>;
+
+    ShaderHotReload(std::filesystem::path shaderDirectory, JobSystem &jobSystem);
+    ~ShaderHotReload();
+    NON_COPYABLE(ShaderHotReload);
+
+    /**
+     * 必须在 Start 之前调用
+     * @param sources 相对于着色器目录的文件名, 例如 shader.vert
+     */
+    void Register(std::string name, std::vector<std::filesystem::path> sources, ReloadCallback callback);
+    void Start();
+
+private:
+    struct Entry {
+        std::string name;
+        std::vector<std::filesystem::path> sources;
+        std::set<std::filesystem::path> dependencies;           // 入口文件和上一次编译包含过的文件, 只由监视任务访问
+        ReloadCallback callback;
+    };
+
+private:
+    void watch();
+    bool pollChanges(int timeoutMs);
+    void scanDependencies(Entry &entry);
+    void rebuild(size_t entryIndex);
+
+private:
+    std::filesystem::path m_directory;
+    ShaderCompiler m_compiler;
+    std::vector<Entry> m_entries;                               // Start 之后不再增删
+
+    JobSystem &m_jobSystem;
+    JobCounter m_watchCounter;                                  // 监视任务完成后重新提交自己, 退出时才归零
+    std::atomic<bool> m_stopping = false;
+    std::set<std::filesystem::path> m_changed;                  // 还在等待静默的变化文件
+    int m_watchHandle = -1;                                     // inotify 描述符
+    std::map<std::filesystem::path, std::filesystem::file_time_type> m_writeTimes; // 没有 inotify 的平台定时比较修改时间
+};
+
+
+#endif //VULKAN_START_SHADERHOTRELOAD_H
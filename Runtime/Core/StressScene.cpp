@@ -0,0 +1,58 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 20:00
+* @version: 1.0
+* @description: 程序化压力测试场景: M 个网格的 N 个实例, 每个实例有自己的位置, 缩放和颜色; 同样的参数总是生成同样的场景
+********************************************************************************/
+
+#include "StressScene.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <glm/gtc/constants.hpp>
+
+constexpr uint32_t MIN_POLYGON_SIDES = 3;
+constexpr uint32_t POLYGON_SIDE_VARIANTS = 10;
+
+StressScene StressScene::Generate(uint32_t meshCount, uint32_t instanceCount, uint32_t seed) {
+    StressScene scene;
+    meshCount = std::max(meshCount, 1u);
+
+    // 以原点为中心, 半径为 1 的正多边形, 三角形扇
+    for(uint32_t i = 0; i < meshCount; i++) {
+        const auto sides = MIN_POLYGON_SIDES + i % POLYGON_SIDE_VARIANTS;
+        const auto phase = static_cast<float>(i) * 0.37f;
+        auto &mesh = scene.meshes.emplace_back();
+        mesh.vertices.push_back({ .position = { 0.0f, 0.0f, 0.0f }, .color = { 1.0f, 1.0f, 1.0f } });
+        for(uint32_t side = 0; side < sides; side++) {
+            const auto angle = glm::two_pi<float>() * static_cast<float>(side) / static_cast<float>(sides) + phase;
+            mesh.vertices.push_back({
+                .position = { std::cos(angle), std::sin(angle), 0.0f },
+                .color = { 0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle), 0.75f },
+            });
+            mesh.indices.insert(mesh.indices.end(), { 0, side + 1, (side + 1) % sides + 1 });
+        }
+    }
+
+    // 实例越多尺寸越小, 使总覆盖面积大致不变
+    const auto scale = std::clamp(1.5f / std::sqrt(static_cast<float>(std::max(instanceCount, 1u))), 0.002f, 0.25f);
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    scene.instances.reserve(instanceCount);
+    scene.instanceMeshes.reserve(instanceCount);
+    for(uint32_t i = 0; i < instanceCount; i++) {
+        scene.instances.push_back({
+            .positionScale = { position(random), position(random), 0.0f, scale * (0.5f + unit(random)) },
+            .color = { 0.3f + 0.7f * unit(random), 0.3f + 0.7f * unit(random), 0.3f + 0.7f * unit(random), 1.0f },
+        });
+        scene.instanceMeshes.push_back(static_cast<uint32_t>(static_cast<uint64_t>(i) * meshCount / instanceCount));
+    }
+    return scene;
+}
+
+glm::vec4 StressScene::TransformSphere(const glm::vec4 &sphere, const InstanceData &instance) {
+    const auto scale = instance.positionScale.w;
+    return { glm::vec3(sphere) * scale + glm::vec3(instance.positionScale), sphere.w * scale };
+}
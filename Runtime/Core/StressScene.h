@@ -0,0 +1,45 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 20:00
+* @version: 1.0
+* @description: 程序化压力测试场景: M 个网格的 N 个实例, 每个实例有自己的位置, 缩放和颜色; 同样的参数总是生成同样的场景
+********************************************************************************/
+
+#ifndef VULKAN_START_STRESSSCENE_H
+#define VULKAN_START_STRESSSCENE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// 与 shader.vert 中的 InstanceData 布局一致 (std430)
+struct InstanceData {
+    glm::vec4 positionScale { 0.0f, 0.0f, 0.0f, 1.0f };         // 平移 xyz, 均匀缩放 w
+    glm::vec4 color { 1.0f };
+};
+
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+struct StressScene {
+    std::vector<MeshData> meshes;
+    std::vector<InstanceData> instances;
+    std::vector<uint32_t> instanceMeshes;                       // 每个实例使用的网格下标, 非降序, 同一网格的实例连续
+
+    /**
+     * @param meshCount 网格数, 第 i 个网格是 3 + i % 10 边形, 逐顶点颜色略有不同
+     * @param instanceCount 实例数, 平均分配给各网格, 随机分布在裁剪空间的 xy 范围内
+     * @param seed
+     */
+    static StressScene Generate(uint32_t meshCount, uint32_t instanceCount, uint32_t seed = 1);
+
+    // 实例经过平移和缩放后的包围球
+    static glm::vec4 TransformSphere(const glm::vec4 &sphere, const InstanceData &instance);
+};
+
+
+#endif //VULKAN_START_STRESSSCENE_H
@@ -0,0 +1,325 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 1:00
+* @version: 1.0
+* @description: 纹理流式加载: I/O 线程读取文件, 任务系统用 stb_image 解码并生成 mip 链, 渲染线程在每帧的上传字节预算内经暂存环形缓冲
+*               从最小的 mip 开始上传, 已上传的 mip 立即可以采样, 更高精度的 mip 在之后的帧中陆续换入
+********************************************************************************/
+
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+#include "Foundation/Log.h"
+
+constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+constexpr uint32_t TEXTURE_TEXEL_SIZE = 4;
+
+namespace {
+
+// mip 在线性空间中平均, 直接平均 sRGB 编码值会使缩小后的纹理偏暗
+const std::array<float, 256> &srgbToLinearTable() {
+    static const auto table = []() {
+        std::array<float, 256> result {};
+        for(size_t i = 0; i < result.size(); i++) {
+            const auto srgb = static_cast<float>(i) / 255.0f;
+            result[i] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+        }
+        return result;
+    }();
+    return table;
+}
+
+uint8_t linearToSrgb(float linear) {
+    const auto srgb = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::clamp(srgb, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+}
+
+TextureStreamer::TextureStreamer(VkDevice device, MemoryAllocator &allocator, UploadManager &uploadManager, BindlessHeap &bindlessHeap,
+                                 JobSystem &jobSystem, VkDeviceSize frameUploadBudget)
+    : m_device(device), m_allocator(allocator), m_uploadManager(uploadManager), m_bindlessHeap(bindlessHeap), m_jobSystem(jobSystem),
+      m_frameUploadBudget(frameUploadBudget) {
+    this->createSampler();
+}
+
+/**
+ * 还没开始的读取和解码直接跳过; 调用前由外部保证设备空闲
+ */
+TextureStreamer::~TextureStreamer() {
+    m_stopping = true;
+    m_jobSystem.Wait(m_pendingJobs);
+
+    for(const auto &retired : m_retiredViews) {
+        vkDestroyImageView(m_device, retired.view, nullptr);
+    }
+    for(auto &texture : m_textures) {
+        m_bindlessHeap.Release(texture.handle);
+        vkDestroyImageView(m_device, texture.view, nullptr);
+    }
+    m_bindlessHeap.Release(m_samplerHandle);
+    vkDestroySampler(m_device, m_sampler, nullptr);
+}
+
+TextureId TextureStreamer::Load(std::filesystem::path path) {
+    const auto texture = static_cast<TextureId>(m_textures.size());
+    m_textures.push_back({ .name = path.filename().string(), .loadTime = std::chrono::steady_clock::now() });
+    // 读取可能阻塞在磁盘上, 放在 I/O 线程; 读完后解码作为低优先级任务继续, 两者都计入 m_pendingJobs
+    m_jobSystem.RunIo([this, texture, path = std::move(path)]() {
+        if(m_stopping) {
+            return;
+        }
+        auto encoded = std::make_shared<std::vector<uint8_t>>(TextureStreamer::readFile(path));
+        m_jobSystem.Run([this, texture, path, encoded]() {
+            if(m_stopping) {
+                return;
+            }
+            auto decoded = TextureStreamer::decode(texture, path, *encoded);
+            std::lock_guard lock(m_decodedMutex);
+            m_decoded.push_back(std::move(decoded));
+        }, &m_pendingJobs, JobPriority::eLow);
+    }, &m_pendingJobs);
+    return texture;
+}
+
+/**
+ * 每次选择所有纹理中下一个待上传 mip 最小的一个, 所有纹理的低精度 mip 都先于任何纹理的高精度 mip 上传;
+ * 本帧至少上传一个 mip, 之后超出预算就停止
+ */
+void TextureStreamer::RecordUploads() {
+    std::vector<DecodedTexture> decoded;
+    {
+        std::lock_guard lock(m_decodedMutex);
+        decoded.swap(m_decoded);
+    }
+    for(auto &each : decoded) {
+        this->acceptDecoded(each);
+    }
+
+    const auto nextMipSize = [this](TextureId texture) {
+        const auto &each = m_textures[texture];
+        return each.mips[each.uploadedLevel - 1].size();
+    };
+    VkDeviceSize uploadedBytes = 0;
+    while(!m_streaming.empty()) {
+        const auto next = std::min_element(m_streaming.begin(), m_streaming.end(),
+            [&](TextureId a, TextureId b) { return nextMipSize(a) < nextMipSize(b); });
+        auto &texture = m_textures[*next];
+        const auto level = texture.uploadedLevel - 1;
+        const auto size = texture.mips[level].size();
+        if(uploadedBytes > 0 && uploadedBytes + size > m_frameUploadBudget) {
+            break;
+        }
+
+        m_uploadManager.UploadImage(*texture.image, level, texture.mips[level].data(),
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+        uploadedBytes += size;
+        std::vector<uint8_t>().swap(texture.mips[level]);
+        texture.uploadedLevel = level;
+        m_viewUpdates.push_back(*next);
+        if(level == 0) {
+            texture.mips.clear();
+            m_streaming.erase(next);
+        }
+    }
+}
+
+void TextureStreamer::BeginFrame(uint64_t frameValue, uint64_t completedValue) {
+    std::erase_if(m_retiredViews, [&](const RetiredView &retired) {
+        if(completedValue < retired.retireValue) {
+            return false;
+        }
+        vkDestroyImageView(m_device, retired.view, nullptr);
+        return true;
+    });
+
+    for(const auto id : m_viewUpdates) {
+        auto &texture = m_textures[id];
+        if(texture.visibleLevel == texture.uploadedLevel) {
+            continue;
+        }
+
+        // 换用新的槽位而不是改写旧槽位, in-flight 帧仍在读取旧槽位的描述符; 旧槽位由 BindlessHeap 延迟回收
+        const auto view = this->createView(texture, texture.uploadedLevel);
+        const auto handle = view != VK_NULL_HANDLE ? m_bindlessHeap.RegisterSampledImage(view) : BindlessHandle {};
+        if(!handle.IsValid()) {
+            vkDestroyImageView(m_device, view, nullptr);
+            continue;
+        }
+        m_bindlessHeap.Release(texture.handle);
+        if(texture.view != VK_NULL_HANDLE) {
+            m_retiredViews.push_back({ .view = texture.view, .retireValue = frameValue });
+        }
+        texture.view = view;
+        texture.handle = handle;
+        texture.visibleLevel = texture.uploadedLevel;
+
+        if(texture.visibleLevel == 0) {
+            const auto &extent = texture.image->GetDesc().extent;
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - texture.loadTime;
+            Log::Info("[Texture] {} fully resident ({}x{}, {} mips) {:.1f} ms after load",
+                texture.name, extent.width, extent.height, texture.mipLevels, elapsed.count());
+        }
+    }
+    m_viewUpdates.clear();
+}
+
+bool TextureStreamer::IsFullyResident(TextureId texture) const {
+    const auto &each = m_textures[texture];
+    return each.mipLevels > 0 && each.visibleLevel == 0;
+}
+
+/**
+ * 在工作线程上执行: 解码为 RGBA8, 再逐级缩小到 1x1
+ */
+std::vector<uint8_t> TextureStreamer::readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if(!file.is_open()) {
+        return {};
+    }
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return bytes;
+}
+
+TextureStreamer::DecodedTexture TextureStreamer::decode(TextureId texture, const std::filesystem::path &path, const std::vector<uint8_t> &encoded) {
+    DecodedTexture decoded { .texture = texture };
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    auto *pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha);
+    if(pixels == nullptr) {
+        Log::Warning("[Texture] failed to decode {}: {}", path.string(), stbi_failure_reason());
+        return decoded;
+    }
+
+    decoded.width = static_cast<uint32_t>(width);
+    decoded.height = static_cast<uint32_t>(height);
+    decoded.mips.emplace_back(pixels, pixels + static_cast<size_t>(width) * height * TEXTURE_TEXEL_SIZE);
+    stbi_image_free(pixels);
+
+    for(auto mipWidth = decoded.width, mipHeight = decoded.height; mipWidth > 1 || mipHeight > 1;) {
+        decoded.mips.push_back(TextureStreamer::downsample(decoded.mips.back(), mipWidth, mipHeight));
+        mipWidth = std::max(mipWidth / 2, 1u);
+        mipHeight = std::max(mipHeight / 2, 1u);
+    }
+    return decoded;
+}
+
+/**
+ * 2x2 盒式滤波, 奇数尺寸时最后一行/列与自身平均; 颜色在线性空间中平均, alpha 直接平均
+ */
+std::vector<uint8_t> TextureStreamer::downsample(const std::vector<uint8_t> &pixels, uint32_t width, uint32_t height) {
+    const auto &toLinear = srgbToLinearTable();
+    const auto dstWidth = std::max(width / 2, 1u);
+    const auto dstHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> result(static_cast<size_t>(dstWidth) * dstHeight * TEXTURE_TEXEL_SIZE);
+
+    for(uint32_t y = 0; y < dstHeight; y++) {
+        const uint32_t rows[] = { std::min(y * 2, height - 1), std::min(y * 2 + 1, height - 1) };
+        for(uint32_t x = 0; x < dstWidth; x++) {
+            const uint32_t columns[] = { std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1) };
+            std::array<float, TEXTURE_TEXEL_SIZE> sum {};
+            for(const auto row : rows) {
+                for(const auto column : columns) {
+                    const auto *texel = &pixels[(static_cast<size_t>(row) * width + column) * TEXTURE_TEXEL_SIZE];
+                    sum[0] += toLinear[texel[0]];
+                    sum[1] += toLinear[texel[1]];
+                    sum[2] += toLinear[texel[2]];
+                    sum[3] += static_cast<float>(texel[3]);
+                }
+            }
+
+            auto *texel = &result[(static_cast<size_t>(y) * dstWidth + x) * TEXTURE_TEXEL_SIZE];
+            texel[0] = linearToSrgb(sum[0] * 0.25f);
+            texel[1] = linearToSrgb(sum[1] * 0.25f);
+            texel[2] = linearToSrgb(sum[2] * 0.25f);
+            texel[3] = static_cast<uint8_t>(sum[3] * 0.25f + 0.5f);
+        }
+    }
+    return result;
+}
+
+/**
+ * 图像一次创建全部 mip, 之后只上传数据
+ */
+void TextureStreamer::acceptDecoded(DecodedTexture &decoded) {
+    if(decoded.mips.empty()) {
+        return;
+    }
+    auto &texture = m_textures[decoded.texture];
+
+    texture.image = m_allocator.CreateImage({
+        .format = TEXTURE_FORMAT,
+        .extent = { decoded.width, decoded.height, 1 },
+        .mipLevels = static_cast<uint32_t>(decoded.mips.size()),
+        .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+    });
+    if(texture.image == nullptr) {
+        return;
+    }
+
+    texture.mipLevels = static_cast<uint32_t>(decoded.mips.size());
+    texture.uploadedLevel = texture.visibleLevel = texture.mipLevels;
+    texture.mips = std::move(decoded.mips);
+    m_streaming.push_back(decoded.texture);
+    LOG_DEBUG("[Texture] {} decoded, {}x{} with {} mips", texture.name, decoded.width, decoded.height, texture.mipLevels);
+}
+
+void TextureStreamer::createSampler() {
+    VkSamplerCreateInfo samplerCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .pNext = nullptr,
+        .magFilter = VK_FILTER_LINEAR,
+        .minFilter = VK_FILTER_LINEAR,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .mipLodBias = 0.0f,
+        .anisotropyEnable = VK_FALSE,
+        .maxAnisotropy = 1.0f,
+        .compareEnable = VK_FALSE,
+        .compareOp = VK_COMPARE_OP_ALWAYS,
+        .minLod = 0.0f,
+        .maxLod = VK_LOD_CLAMP_NONE,
+        .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
+        .unnormalizedCoordinates = VK_FALSE,
+    };
+    const auto result = vkCreateSampler(m_device, &samplerCreateInfo, nullptr, &m_sampler);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create texture sampler!");
+    m_samplerHandle = m_bindlessHeap.RegisterSampler(m_sampler);
+}
+
+/**
+ * 视图只包含已上传的 mip, 采样时 LOD 相对于 baseMipLevel 计算, 未上传的高精度 mip 不会被访问
+ */
+VkImageView TextureStreamer::createView(const Texture &texture, uint32_t baseMipLevel) const {
+    VkImageViewCreateInfo viewCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .pNext = nullptr,
+        .image = texture.image->GetHandle(),
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = TEXTURE_FORMAT,
+        .components = {},
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = baseMipLevel,
+            .levelCount = texture.mipLevels - baseMipLevel,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+    };
+    VkImageView view = nullptr;
+    const auto result = vkCreateImageView(m_device, &viewCreateInfo, nullptr, &view);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to create texture view!");
+    return result == VK_SUCCESS ? view : VK_NULL_HANDLE;
+}
@@ -0,0 +1,119 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/18 1:00
+* @version: 1.0
+* @description: 纹理流式加载: I/O 线程读取文件, 任务系统用 stb_image 解码并生成 mip 链, 渲染线程在每帧的上传字节预算内经暂存环形缓冲
+*               从最小的 mip 开始上传, 已上传的 mip 立即可以采样, 更高精度的 mip 在之后的帧中陆续换入
+********************************************************************************/
+
+#ifndef VULKAN_START_TEXTURESTREAMER_H
+#define VULKAN_START_TEXTURESTREAMER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "BindlessHeap.h"
+#include "Foundation/PreprocessorDirectives.h"
+#include "Foundation/JobSystem.h"
+
+class MemoryAllocator;
+class UploadManager;
+class GpuImage;
+
+using TextureId = uint32_t;
+
+class TextureStreamer {
+public:
+    /**
+     * @param frameUploadBudget 每帧最多写入暂存环形缓冲的纹理字节数; 单个 mip 超过预算时独占一帧
+     * @param jobSystem 文件读取提交到 I/O 线程, 解码作为低优先级任务
+     */
+    TextureStreamer(VkDevice device, MemoryAllocator &allocator, UploadManager &uploadManager, BindlessHeap &bindlessHeap,
+                    JobSystem &jobSystem, VkDeviceSize frameUploadBudget);
+    ~TextureStreamer();
+    NON_COPYABLE(TextureStreamer);
+
+    // 立即返回, 读取和解码都在后台进行; 只能在渲染线程调用
+    TextureId Load(std::filesystem::path path);
+
+    // 在 UploadManager::Submit 之前调用: 接收解码完成的纹理, 在预算内录制 mip 的上传
+    void RecordUploads();
+
+    /**
+     * 在 UploadManager::Submit 之后, 录制命令之前调用: 本帧命令缓冲开头会获取已上传的 mip, 这里切换到包含它们的视图;
+     * 被换下的视图和 bindless 槽位在引用它们的帧完成后回收
+     * @param frameValue 本帧图形提交的时间线值
+     * @param completedValue 图形时间线已完成的值
+     */
+    void BeginFrame(uint64_t frameValue, uint64_t completedValue);
+
+    // 还没有任何 mip 可以采样时返回无效句柄, 调用方使用自己的默认纹理; 句柄在更多 mip 换入后会变化, 每帧录制时重新读取
+    [[nodiscard]] BindlessHandle GetHandle(TextureId texture) const { return m_textures[texture].handle; }
+    [[nodiscard]] BindlessHandle GetSamplerHandle() const { return m_samplerHandle; }
+    [[nodiscard]] bool IsFullyResident(TextureId texture) const;
+
+private:
+    // 工作线程的输出, 第 0 级为原图
+    struct DecodedTexture {
+        TextureId texture = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<std::vector<uint8_t>> mips;                 // 空表示解码失败
+    };
+
+    struct Texture {
+        std::string name;
+        std::chrono::steady_clock::time_point loadTime;
+        std::unique_ptr<GpuImage> image;
+        std::vector<std::vector<uint8_t>> mips;                 // 上传之后释放对应的像素
+        uint32_t mipLevels = 0;
+        uint32_t uploadedLevel = 0;                             // 已上传的最高精度 mip, 等于 mipLevels 表示还没有上传
+        uint32_t visibleLevel = 0;                              // 当前视图的 baseMipLevel, 等于 mipLevels 表示还没有视图
+        VkImageView view = nullptr;
+        BindlessHandle handle;
+    };
+
+    struct RetiredView {
+        VkImageView view = nullptr;
+        uint64_t retireValue = 0;
+    };
+
+private:
+    static std::vector<uint8_t> readFile(const std::filesystem::path &path);
+    static DecodedTexture decode(TextureId texture, const std::filesystem::path &path, const std::vector<uint8_t> &encoded);
+    static std::vector<uint8_t> downsample(const std::vector<uint8_t> &pixels, uint32_t width, uint32_t height);
+    void acceptDecoded(DecodedTexture &decoded);
+    void createSampler();
+    VkImageView createView(const Texture &texture, uint32_t baseMipLevel) const;
+
+private:
+    VkDevice m_device = nullptr;
+    MemoryAllocator &m_allocator;
+    UploadManager &m_uploadManager;
+    BindlessHeap &m_bindlessHeap;
+    JobSystem &m_jobSystem;
+    VkDeviceSize m_frameUploadBudget = 0;
+
+    VkSampler m_sampler = nullptr;
+    BindlessHandle m_samplerHandle;
+    std::vector<Texture> m_textures;                            // 以 TextureId 为下标, 只由渲染线程访问
+    std::vector<TextureId> m_streaming;                         // 还有 mip 没有上传的纹理
+    std::vector<TextureId> m_viewUpdates;                       // 本帧上传了新 mip, 需要在 BeginFrame 中换视图
+    std::vector<RetiredView> m_retiredViews;
+
+    JobCounter m_pendingJobs;                                   // 析构时等待, 任务访问 m_decoded
+    std::atomic<bool> m_stopping = false;                       // 析构时还没开始的读取和解码直接跳过
+
+    std::mutex m_decodedMutex;
+    std::vector<DecodedTexture> m_decoded;
+};
+
+
+#endif //VULKAN_START_TEXTURESTREAMER_H
@@ -0,0 +1,422 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 13:00
+* @version: 1.0
+* @description: 常驻映射的暂存环形缓冲 + 每帧一次批量提交的上传管理器, 有独立传输队列族时在其上执行拷贝
+********************************************************************************/
+
+#include "UploadManager.h"
+#include <algorithm>
+#include <cstring>
+#include "MemoryAllocator.h"
+#include "Queue.h"
+#include "Foundation/Log.h"
+
+constexpr VkDeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024;
+constexpr VkDeviceSize STAGING_CHUNK_SIZE = STAGING_RING_SIZE / 4;     // 大块数据分段上传, 避免一次占满环形缓冲
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;                  // 同时满足缓冲到图像拷贝的 texel 对齐
+constexpr VkDeviceSize IMAGE_TEXEL_SIZE = 4;                    // UploadImage 只支持 RGBA8 这类每像素 4 字节的格式
+
+namespace {
+
+VkImageSubresourceRange makeMipRange(uint32_t mipLevel) {
+    return {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = mipLevel,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+}
+
+// 拷贝写入时处于 TRANSFER_DST_OPTIMAL, 拷贝完成后转换为着色器只读布局
+ImageOwnershipTransfer makeImageTransfer(VkImage image, uint32_t mipLevel, uint32_t srcFamily, uint32_t dstFamily) {
+    return {
+        .image = image,
+        .range = makeMipRange(mipLevel),
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcFamily = srcFamily,
+        .dstFamily = dstFamily,
+    };
+}
+
+}
+
+UploadManager::UploadManager(VkDevice device, MemoryAllocator &allocator, Queue &transferQueue, uint32_t graphicsFamily, uint32_t framesInFlight)
+    : m_device(device), m_transferQueue(transferQueue), m_transferFamily(transferQueue.GetFamilyIndex()), m_graphicsFamily(graphicsFamily) {
+    m_ringSize = STAGING_RING_SIZE;
+    m_ring = allocator.CreateBuffer({
+        .size = m_ringSize,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .domain = MemoryDomain::eUpload,
+    });
+
+    m_slots.resize(framesInFlight);
+    for(auto &slot : m_slots) {
+        VkCommandPoolCreateInfo commandPoolCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = m_transferFamily
+        };
+        auto result = vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &slot.commandPool);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create upload command pool!");
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = slot.commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+        result = vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &slot.commandBuffer);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate upload command buffer!");
+    }
+
+    Log::Info("Uploads use {} queue family {}", this->UsesDedicatedQueue() ? "dedicated transfer" : "graphics", m_transferFamily);
+}
+
+UploadManager::~UploadManager() {
+    // 传输队列可能与图形队列共用, 只等待上传自己的提交
+    for(const auto &slot : m_slots) {
+        m_transferQueue.Wait(slot.submitValue);
+        vkDestroyCommandPool(m_device, slot.commandPool, nullptr);
+    }
+}
+
+/**
+ * 把数据写入暂存环形缓冲并录制拷贝命令, 实际提交推迟到本帧的 Submit
+ * @param dst 目标缓冲, 以 VK_SHARING_MODE_EXCLUSIVE 创建
+ * @param dstOffset
+ * @param data
+ * @param size
+ * @param dstStage 目标队列上首次使用该数据的阶段
+ * @param dstAccess 目标队列上首次使用该数据的访问类型
+ * @param dstFamily 使用该数据的队列族, 默认为图形队列族; 由该队列族的命令缓冲调用 RecordAcquireBarriers
+ */
+void UploadManager::UploadBuffer(const GpuBuffer &dst, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+                                 VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, uint32_t dstFamily) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for(VkDeviceSize copied = 0; copied < size;) {
+        const auto chunkSize = std::min(size - copied, STAGING_CHUNK_SIZE);
+
+        VkDeviceSize stagingOffset = 0;
+        if(!this->allocate(chunkSize, STAGING_ALIGNMENT, stagingOffset)) {
+            // 环形缓冲已满: 提前提交已录制的拷贝并等待完成, 只在单帧上传量超过缓冲容量时发生
+            this->flushAndWait();
+            this->allocate(chunkSize, STAGING_ALIGNMENT, stagingOffset);
+        }
+
+        this->ensureRecording();
+        std::memcpy(static_cast<uint8_t *>(m_ring->GetMappedData()) + stagingOffset, bytes + copied, chunkSize);
+
+        VkBufferCopy region {
+            .srcOffset = stagingOffset,
+            .dstOffset = dstOffset + copied,
+            .size = chunkSize
+        };
+        vkCmdCopyBuffer(m_slots[m_slotIndex].commandBuffer, m_ring->GetHandle(), dst.GetHandle(), 1, &region);
+        copied += chunkSize;
+    }
+
+    m_pendingRegions.push_back({
+        .buffer = dst.GetHandle(),
+        .offset = dstOffset,
+        .size = size,
+        .dstStage = dstStage,
+        .dstAccess = dstAccess,
+        .dstFamily = dstFamily == VK_QUEUE_FAMILY_IGNORED ? m_graphicsFamily : dstFamily,
+    });
+}
+
+/**
+ * 把图像的一个 mip 写入暂存环形缓冲并录制拷贝, 较大的 mip 按行分段; 该 mip 原有的内容被丢弃
+ * @param dst 目标图像, 以 VK_SHARING_MODE_EXCLUSIVE 和 TRANSFER_DST 用途创建, 每像素 4 字节
+ * @param mipLevel
+ * @param data 紧密排列的像素, 大小由 mip 的尺寸决定
+ * @param dstStage 目标队列上首次采样该图像的阶段
+ * @param dstAccess
+ * @param dstFamily 与 UploadBuffer 相同; 目标队列族的 RecordAcquireBarriers 把该 mip 转换为 SHADER_READ_ONLY_OPTIMAL
+ */
+void UploadManager::UploadImage(const GpuImage &dst, uint32_t mipLevel, const void *data,
+                                VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, uint32_t dstFamily) {
+    const auto &desc = dst.GetDesc();
+    const auto width = std::max(desc.extent.width >> mipLevel, 1u);
+    const auto height = std::max(desc.extent.height >> mipLevel, 1u);
+    const auto rowSize = width * IMAGE_TEXEL_SIZE;
+    const auto rowsPerChunk = static_cast<uint32_t>(std::max<VkDeviceSize>(STAGING_CHUNK_SIZE / rowSize, 1));
+    const auto *bytes = static_cast<const uint8_t *>(data);
+
+    auto transitioned = false;
+    for(uint32_t row = 0; row < height;) {
+        const auto rowCount = std::min(height - row, rowsPerChunk);
+        const auto chunkSize = rowCount * rowSize;
+
+        VkDeviceSize stagingOffset = 0;
+        if(!this->allocate(chunkSize, STAGING_ALIGNMENT, stagingOffset)) {
+            this->flushAndWait();
+            this->allocate(chunkSize, STAGING_ALIGNMENT, stagingOffset);
+        }
+
+        this->ensureRecording();
+        const auto commandBuffer = m_slots[m_slotIndex].commandBuffer;
+        if(!transitioned) {
+            // 之前的内容不需要保留, 从 UNDEFINED 转换; 中途提前提交时后续分段沿用已转换的布局
+            const VkImageMemoryBarrier2 barrier {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .pNext = nullptr,
+                .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+                .srcAccessMask = VK_ACCESS_2_NONE,
+                .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = dst.GetHandle(),
+                .subresourceRange = makeMipRange(mipLevel)
+            };
+            VkDependencyInfo dependencyInfo {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount = 1,
+                .pImageMemoryBarriers = &barrier,
+            };
+            vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+            transitioned = true;
+        }
+        std::memcpy(static_cast<uint8_t *>(m_ring->GetMappedData()) + stagingOffset, bytes + static_cast<size_t>(row) * rowSize, chunkSize);
+
+        VkBufferImageCopy region {
+            .bufferOffset = stagingOffset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = mipLevel, .baseArrayLayer = 0, .layerCount = 1 },
+            .imageOffset = { 0, static_cast<int32_t>(row), 0 },
+            .imageExtent = { width, rowCount, 1 },
+        };
+        vkCmdCopyBufferToImage(commandBuffer, m_ring->GetHandle(), dst.GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        row += rowCount;
+    }
+
+    m_pendingImageRegions.push_back({
+        .image = dst.GetHandle(),
+        .mipLevel = mipLevel,
+        .dstStage = dstStage,
+        .dstAccess = dstAccess,
+        .dstFamily = dstFamily == VK_QUEUE_FAMILY_IGNORED ? m_graphicsFamily : dstFamily,
+    });
+}
+
+/**
+ * 提交本帧录制的全部拷贝, 每帧最多一次
+ * @return 使用上传数据的第一个提交需要等待的时间线值和阶段, 用 GetQueue().MakeWaitInfo 生成等待信息
+ */
+UploadSubmission UploadManager::Submit() {
+    auto &slot = m_slots[m_slotIndex];
+    if(!slot.recording) {
+        return {};
+    }
+
+    m_ring->Flush();
+    this->recordReleaseBarriers(slot.commandBuffer);
+    vkEndCommandBuffer(slot.commandBuffer);
+
+    slot.submitValue = m_transferQueue.Submit({ &slot.commandBuffer, 1 }, {}, {});
+
+    UploadSubmission submission { .value = slot.submitValue };
+    for(const auto &region : m_pendingRegions) {
+        submission.waitStage |= region.dstStage;
+    }
+    for(const auto &region : m_pendingImageRegions) {
+        submission.waitStage |= region.dstStage;
+    }
+    LOG_DEBUG("[Upload] submitted {} buffer regions and {} image regions, staging ring {} / {} bytes in use",
+        m_pendingRegions.size(), m_pendingImageRegions.size(), m_head - m_tail, m_ringSize);
+    m_acquireRegions.insert(m_acquireRegions.end(), m_pendingRegions.begin(), m_pendingRegions.end());
+    m_pendingRegions.clear();
+    m_acquireImageRegions.insert(m_acquireImageRegions.end(), m_pendingImageRegions.begin(), m_pendingImageRegions.end());
+    m_pendingImageRegions.clear();
+
+    slot.ringEnd = m_head;
+    slot.recording = false;
+    m_slotIndex = (m_slotIndex + 1) % static_cast<uint32_t>(m_slots.size());
+    return submission;
+}
+
+/**
+ * 在目标队列族的命令缓冲开头调用, 只处理以该队列族为目标的区间: 跨队列族时获取缓冲所有权,
+ * 同队列族时只需让传输写入对后续阶段可见; 图像在这里转换为着色器只读布局
+ * @param commandBuffer
+ * @param queueFamily 命令缓冲所属的队列族
+ */
+void UploadManager::RecordAcquireBarriers(VkCommandBuffer commandBuffer, uint32_t queueFamily) {
+    std::vector<VkBufferMemoryBarrier2> barriers;
+    for(const auto &region : m_acquireRegions) {
+        if(region.dstFamily != queueFamily) continue;
+
+        const BufferOwnershipTransfer transfer {
+            .buffer = region.buffer,
+            .offset = region.offset,
+            .size = region.size,
+            .srcFamily = m_transferFamily,
+            .dstFamily = region.dstFamily,
+        };
+        if(transfer.IsRequired()) {
+            barriers.push_back(transfer.Acquire(region.dstStage, region.dstAccess));
+            continue;
+        }
+        barriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .pNext = nullptr,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = region.dstStage,
+            .dstAccessMask = region.dstAccess,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = region.buffer,
+            .offset = region.offset,
+            .size = region.size
+        });
+    }
+    std::vector<VkImageMemoryBarrier2> imageBarriers;
+    for(const auto &region : m_acquireImageRegions) {
+        if(region.dstFamily != queueFamily) continue;
+
+        const auto transfer = makeImageTransfer(region.image, region.mipLevel, m_transferFamily, region.dstFamily);
+        if(transfer.IsRequired()) {
+            imageBarriers.push_back(transfer.Acquire(region.dstStage, region.dstAccess));
+            continue;
+        }
+        imageBarriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .pNext = nullptr,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = region.dstStage,
+            .dstAccessMask = region.dstAccess,
+            .oldLayout = transfer.oldLayout,
+            .newLayout = transfer.newLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = region.image,
+            .subresourceRange = transfer.range
+        });
+    }
+    if(barriers.empty() && imageBarriers.empty()) {
+        return;
+    }
+
+    VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.size()),
+        .pBufferMemoryBarriers = barriers.data(),
+        .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+        .pImageMemoryBarriers = imageBarriers.data(),
+    };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    std::erase_if(m_acquireRegions, [queueFamily](const PendingRegion &region) { return region.dstFamily == queueFamily; });
+    std::erase_if(m_acquireImageRegions, [queueFamily](const PendingImageRegion &region) { return region.dstFamily == queueFamily; });
+}
+
+void UploadManager::recordReleaseBarriers(VkCommandBuffer commandBuffer) {
+    std::vector<VkBufferMemoryBarrier2> barriers;
+    for(const auto &region : m_pendingRegions) {
+        const BufferOwnershipTransfer transfer {
+            .buffer = region.buffer,
+            .offset = region.offset,
+            .size = region.size,
+            .srcFamily = m_transferFamily,
+            .dstFamily = region.dstFamily,
+        };
+        if(transfer.IsRequired()) {
+            barriers.push_back(transfer.Release(VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+        }
+    }
+    std::vector<VkImageMemoryBarrier2> imageBarriers;
+    for(const auto &region : m_pendingImageRegions) {
+        const auto transfer = makeImageTransfer(region.image, region.mipLevel, m_transferFamily, region.dstFamily);
+        if(transfer.IsRequired()) {
+            imageBarriers.push_back(transfer.Release(VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+        }
+    }
+    if(barriers.empty() && imageBarriers.empty()) {
+        return;
+    }
+
+    VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.size()),
+        .pBufferMemoryBarriers = barriers.data(),
+        .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+        .pImageMemoryBarriers = imageBarriers.data(),
+    };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+/**
+ * 第一次写入某个槽位时才开始录制: 等待该槽位上一批拷贝 (通常早已完成), 回收其占用的环形缓冲空间
+ */
+void UploadManager::ensureRecording() {
+    auto &slot = m_slots[m_slotIndex];
+    if(slot.recording) {
+        return;
+    }
+
+    m_transferQueue.Wait(slot.submitValue);
+    m_tail = std::max(m_tail, slot.ringEnd);
+
+    vkResetCommandPool(m_device, slot.commandPool, 0);
+    VkCommandBufferBeginInfo beginInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vkBeginCommandBuffer(slot.commandBuffer, &beginInfo);
+    slot.recording = true;
+}
+
+bool UploadManager::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset) {
+    // 先回收所有已完成批次的空间
+    const auto completedValue = m_transferQueue.GetCompletedValue();
+    for(const auto &slot : m_slots) {
+        if(!slot.recording && slot.submitValue <= completedValue) {
+            m_tail = std::max(m_tail, slot.ringEnd);
+        }
+    }
+
+    auto start = (m_head + alignment - 1) / alignment * alignment;
+    if(start % m_ringSize + size > m_ringSize) {
+        // 剩余尾部放不下, 从环的起点重新开始
+        start = (start / m_ringSize + 1) * m_ringSize;
+    }
+    if(start + size - m_tail > m_ringSize) {
+        return false;
+    }
+
+    m_head = start + size;
+    offset = start % m_ringSize;
+    return true;
+}
+
+void UploadManager::flushAndWait() {
+    auto &slot = m_slots[m_slotIndex];
+    if(slot.recording) {
+        m_ring->Flush();
+        this->recordReleaseBarriers(slot.commandBuffer);
+        vkEndCommandBuffer(slot.commandBuffer);
+
+        slot.submitValue = m_transferQueue.Submit({ &slot.commandBuffer, 1 }, {}, {});
+        m_acquireRegions.insert(m_acquireRegions.end(), m_pendingRegions.begin(), m_pendingRegions.end());
+        m_pendingRegions.clear();
+        m_acquireImageRegions.insert(m_acquireImageRegions.end(), m_pendingImageRegions.begin(), m_pendingImageRegions.end());
+        m_pendingImageRegions.clear();
+        slot.recording = false;
+    }
+
+    // 每个槽位最近一次提交的时间线值都已到达, 整个环形缓冲才空闲
+    for(const auto &each : m_slots) {
+        m_transferQueue.Wait(each.submitValue);
+    }
+    slot.ringEnd = m_head;
+    m_tail = m_head;
+}
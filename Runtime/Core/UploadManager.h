@@ -0,0 +1,95 @@
+/********************************************************************************
+* @author: TURIING
+* @email: turiing@163.com
+* @date: 2026/10/17 13:00
+* @version: 1.0
+* @description: 常驻映射的暂存环形缓冲 + 每帧一次批量提交的上传管理器, 有独立传输队列族时在其上执行拷贝
+********************************************************************************/
+
+#ifndef VULKAN_START_UPLOADMANAGER_H
+#define VULKAN_START_UPLOADMANAGER_H
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Foundation/PreprocessorDirectives.h"
+
+class MemoryAllocator;
+class GpuBuffer;
+class GpuImage;
+class Queue;
+
+struct UploadSubmission {
+    uint64_t value = 0;                                         // 传输队列的时间线值, 本帧无上传时为 0
+    VkPipelineStageFlags2 waitStage = VK_PIPELINE_STAGE_2_NONE; // 图形队列上首次使用上传数据的阶段
+};
+
+class UploadManager {
+public:
+    UploadManager(VkDevice device, MemoryAllocator &allocator, Queue &transferQueue, uint32_t graphicsFamily, uint32_t framesInFlight);
+    ~UploadManager();
+    NON_COPYABLE(UploadManager);
+
+    void UploadBuffer(const GpuBuffer &dst, VkDeviceSize dstOffset, const void *data, VkDeviceSize size,
+                      VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED);
+    void UploadImage(const GpuImage &dst, uint32_t mipLevel, const void *data,
+                     VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess, uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED);
+    [[nodiscard]] UploadSubmission Submit();
+    [[nodiscard]] const Queue &GetQueue() const { return m_transferQueue; }
+    void RecordAcquireBarriers(VkCommandBuffer commandBuffer, uint32_t queueFamily);
+    [[nodiscard]] bool UsesDedicatedQueue() const { return m_transferFamily != m_graphicsFamily; }
+
+private:
+    struct FrameSlot {
+        VkCommandPool commandPool = nullptr;
+        VkCommandBuffer commandBuffer = nullptr;
+        uint64_t submitValue = 0;                               // 上一批拷贝的时间线值, 完成前不能复用该槽位
+        uint64_t ringEnd = 0;                                   // 该批次提交时的环形缓冲写指针, 完成后可回收到这里
+        bool recording = false;
+    };
+
+    struct PendingRegion {
+        VkBuffer buffer = nullptr;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        VkPipelineStageFlags2 dstStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 dstAccess = VK_ACCESS_2_NONE;
+        uint32_t dstFamily = 0;                                 // 使用该数据的队列族, 与传输队列族不同时需要转移所有权
+    };
+
+    // 图像按 mip 记录, 拷贝完成后转换为 SHADER_READ_ONLY_OPTIMAL
+    struct PendingImageRegion {
+        VkImage image = nullptr;
+        uint32_t mipLevel = 0;
+        VkPipelineStageFlags2 dstStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 dstAccess = VK_ACCESS_2_NONE;
+        uint32_t dstFamily = 0;
+    };
+
+private:
+    void ensureRecording();
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset);
+    void recordReleaseBarriers(VkCommandBuffer commandBuffer);
+    void flushAndWait();
+
+private:
+    VkDevice m_device = nullptr;
+    Queue &m_transferQueue;
+    uint32_t m_transferFamily = 0;
+    uint32_t m_graphicsFamily = 0;
+
+    std::unique_ptr<GpuBuffer> m_ring;
+    VkDeviceSize m_ringSize = 0;
+    uint64_t m_head = 0;                                        // 单调递增的逻辑偏移, 对 m_ringSize 取模得到物理偏移
+    uint64_t m_tail = 0;
+
+    std::vector<FrameSlot> m_slots;
+    uint32_t m_slotIndex = 0;
+    std::vector<PendingRegion> m_pendingRegions;                // 已录制拷贝, 尚未提交
+    std::vector<PendingRegion> m_acquireRegions;                // 已提交, 等待目标队列获取所有权
+    std::vector<PendingImageRegion> m_pendingImageRegions;
+    std::vector<PendingImageRegion> m_acquireImageRegions;
+};
+
+
+#endif //VULKAN_START_UPLOADMANAGER_H
@@ -13,10 +13,28 @@
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <GLFW/glfw3.h>
 #include "../BaseDefine.h"
 #include "Window.h"
+#include "GpuProfiler.h"
+#include "PipelineCache.h"
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+#include "Mesh.h"
+#include "RenderGraph.h"
+#include "BindlessHeap.h"
+#include "GpuCulling.h"
+#include "StressScene.h"
+#include "Queue.h"
+#include "ShaderHotReload.h"
+#include "PipelineCompiler.h"
+#include "TextureStreamer.h"
+#include "Foundation/AssetPack.h"
+#include "RenderPacket.h"
 #include "Foundation/Log.h"
+#include "Foundation/JobSystem.h"
 
 #ifndef NDEBUG
 #define ENABLE_VALIDATION_LAYERS
@@ -26,11 +44,33 @@ const std::vector<const char*> REQUIRE_DEVICE_EXTENSION = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+// 设备支持时才开启的扩展, 是否开启通过 isDeviceExtensionEnabled 查询
+const std::vector<const char*> OPTIONAL_DEVICE_EXTENSION = {
+    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+    VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME
+};
+
+// 依赖 VK_KHR_swapchain, 只在有窗口并且两者的特性都支持时开启
+const std::vector<const char*> PRESENT_WAIT_DEVICE_EXTENSION = {
+    VK_KHR_PRESENT_ID_EXTENSION_NAME,
+    VK_KHR_PRESENT_WAIT_EXTENSION_NAME
+};
+
+// headless 模式下离屏颜色目标的格式, 与 PNG 的字节序一致, 读回后无需转换
+constexpr VkFormat OFFSCREEN_COLOR_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+constexpr size_t MIN_DRAWS_PER_SLICE = 512;                     // 绘制太少时多线程录制的分发开销大于收益
+constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100'000'000;          // 低延迟模式下等待显示的上限 (ns), 窗口被遮挡时呈现可能一直不完成
+constexpr size_t MAX_PENDING_PRESENTS = 16;                     // 超过时丢弃最早的延迟记录
+
 struct QueueFamilyIndices{
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> computeFamily;                      // 没有独立计算队列族时与 graphicsFamily 相同
+    std::optional<uint32_t> transferFamily;                     // 没有独立传输队列族时与 graphicsFamily 相同
+    bool requirePresent = true;
 
-    [[nodiscard]] bool isComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
+    [[nodiscard]] bool isComplete() const { return graphicsFamily.has_value() && (presentFamily.has_value() || !requirePresent); }
 };
 
 struct SwapChainSupportDetails {
@@ -39,50 +79,106 @@ struct SwapChainSupportDetails {
     std::vector<VkPresentModeKHR> presentModes;
 };
 
-VkContext::VkContext(std::shared_ptr<Window> &window): m_window(window) {
-    m_requiredExtensions = window->GetGlfwExtensionInfo();
+VkContext::VkContext(std::shared_ptr<Window> &window, JobSystem &jobSystem, const RenderSettings &settings)
+    : m_window(window), m_jobSystem(jobSystem), m_settings(settings) {
+    m_settings.framesInFlight = std::clamp(m_settings.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    if(!m_settings.headless) {
+        m_requiredExtensions = window->GetGlfwExtensionInfo();
+        m_framebufferSize = window->GetFrameBufferSize();
+    }
     this->createInstance();
     this->setupDebugMessager();
     this->createSurface();
     this->pickPhysicalDevice();
     this->createLogicalDevice();
-    this->createSwapChain();
+    this->createMemoryAllocator();
+    this->createUploadManager();
+    this->createRenderGraph();
+    this->createBindlessHeap();
+    if(m_settings.headless) {
+        this->createOffscreenImages();
+    }
+    else {
+        this->createSwapChain();
+    }
     this->createSwapChainImageViews();
-    this->createRenderPass();
+    this->createPipelineCache();
+    this->createAssetPack();
+    this->createPipelineLayout();
+    this->createPipelineCompiler();
     this->createGraphicsPipeline();
-    this->createFramebuffers();
     this->createCommandPool();
     this->createCommandBuffers();
+    this->createGpuProfiler();
+    this->createMeshes();
+    this->createGpuCulling();
+    this->createTextureStreamer();
+    this->createShaderHotReload();
     this->createSyncObjects();
+    if(m_settings.headless) {
+        this->createReadbackBuffers();
+    }
+    this->waitForStartupPipelines();
+    this->createCullObjects();
 }
 
 VkContext::~VkContext() {
-    vkDestroySemaphore(m_device, m_renderFinishedSemaphore, nullptr);
-    vkDestroySemaphore(m_device, m_imageAvailableSemaphore, nullptr);
-    vkDestroyFence(m_device, m_inFlightFence, nullptr);
-
-    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
-
-    for (auto framebuffer : m_swapChainFrameBuffers) {
-        vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+    this->destroyRetiredSwapChains(true);
+    m_memoryAllocator->EndDefragmentation();
+    m_shaderHotReload.reset();
+    m_pipelineCompiler.reset();
+    m_assetPack.reset();
+    m_gpuProfiler.reset();
+
+    for(auto semaphore : m_renderFinishedSemaphores) {
+        vkDestroySemaphore(m_device, semaphore, nullptr);
+    }
+    for(auto &frame : m_frames) {
+        vkDestroySemaphore(m_device, frame.imageAvailableSemaphore, nullptr);
+        vkDestroyCommandPool(m_device, frame.commandPool, nullptr);
+        vkDestroyCommandPool(m_device, frame.computeCommandPool, nullptr);
+        for(const auto &workerCommands : frame.workerCommands) {
+            vkDestroyCommandPool(m_device, workerCommands.commandPool, nullptr);
+        }
+        frame.readbackBuffer.reset();
     }
 
+    m_gpuCulling.reset();
+    m_textureStreamer.reset();
+    m_bindlessHeap->Release(m_instanceBufferHandle);
+    m_instanceBuffer.reset();
+    m_meshes.clear();
     vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
+    m_pipelineCache->Save();
+    m_pipelineCache.reset();
     vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
-    vkDestroyRenderPass(m_device, m_renderPass, nullptr);
 
     for(auto imageView : m_swapChainImageViews) {
         vkDestroyImageView(m_device, imageView, nullptr);
     }
-    vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
+    if(m_settings.headless) {
+        m_offscreenImages.clear();
+    }
+    else {
+        vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
+    }
 
+    m_computeGraph.reset();
+    m_renderGraph.reset();
+    m_bindlessHeap.reset();
+    m_uploadManager.reset();
+    m_memoryAllocator.reset();
+    m_graphicsQueue = m_presentQueue = m_computeQueue = m_transferQueue = nullptr;
+    m_queues.clear();
     vkDestroyDevice(m_device, nullptr);
 
 #ifdef ENABLE_VALIDATION_LAYERS
     VkContext::destroyDebugUtilsMessengerExt(m_instance, m_debugMessenger, nullptr);
 #endif
 
-    vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    if(m_surface != nullptr) {
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    }
     vkDestroyInstance(m_instance, nullptr);
 }
 
@@ -230,39 +326,85 @@ void VkContext::pickPhysicalDevice() {
 bool VkContext::isDeviceSuitable(VkPhysicalDevice device) {
     const auto indices = this->findQueueFamilies(device);
 
-    const auto extensionSupported = VkContext::checkDeviceExtensionSupport(device);
+    const auto extensionSupported = this->checkDeviceExtensionSupport(device);
 
-    auto isSwapChainAdequate = false;
-    if(extensionSupported) {
+    // headless 模式不需要交换链
+    auto isSwapChainAdequate = m_settings.headless;
+    if(extensionSupported && !m_settings.headless) {
         const auto swapChainSupportDetails = this->querySwapChainSupport(device);
         isSwapChainAdequate = !swapChainSupportDetails.formats.empty() && !swapChainSupportDetails.presentModes.empty();
     }
 
-    return indices.isComplete() && extensionSupported && isSwapChainAdequate;
+    // 渲染路径基于动态渲染和 synchronization2, 两者都是 Vulkan 1.3 的必需功能, 这里防止驱动只报告了 1.2;
+    // bindless 描述符堆依赖的描述符索引功能在 1.2 中是可选的, 需要逐项检查
+    VkPhysicalDeviceVulkan13Features vulkan13Features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+    };
+    VkPhysicalDeviceVulkan12Features vulkan12Features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &vulkan13Features,
+    };
+    VkPhysicalDeviceFeatures2 features2 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12Features,
+    };
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    const auto featuresSupported = vulkan13Features.dynamicRendering == VK_TRUE && vulkan13Features.synchronization2 == VK_TRUE &&
+        vulkan12Features.runtimeDescriptorArray == VK_TRUE && vulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing == VK_TRUE &&
+        vulkan12Features.timelineSemaphore == VK_TRUE;
+
+    return indices.isComplete() && extensionSupported && isSwapChainAdequate && featuresSupported;
 }
 
 QueueFamilyIndices VkContext::findQueueFamilies(VkPhysicalDevice device) {
     QueueFamilyIndices indices;
+    indices.requirePresent = !m_settings.headless;
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
 
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
-    for(auto i = 0; const auto &queueFamily : queueFamilies) {
-        if(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+    for(uint32_t i = 0; const auto &queueFamily : queueFamilies) {
+        if(!indices.graphicsFamily.has_value() && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
             indices.graphicsFamily = i;
         }
 
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
-        if(presentSupport) indices.presentFamily = i;
+        if(indices.requirePresent) {
+            // 优先与图形队列同族, 交换链图像不需要并发共享
+            VkBool32 presentSupport = false;
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+            if(presentSupport && (!indices.presentFamily.has_value() || i == indices.graphicsFamily)) indices.presentFamily = i;
+        }
+
+        // 只有传输能力的队列族通常对应独立的 DMA 引擎, 拷贝可以和图形队列并行
+        const auto isTransferOnly = (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                                    !(queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+        if(!indices.transferFamily.has_value() && isTransferOnly) {
+            indices.transferFamily = i;
+        }
 
-        if(indices.isComplete()) break;
+        // 没有图形能力的计算队列族对应异步计算引擎, 可以和图形队列并行执行
+        const auto isComputeOnly = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+        if(!indices.computeFamily.has_value() && isComputeOnly) {
+            indices.computeFamily = i;
+        }
 
         i++;
     }
 
+    if(!indices.transferFamily.has_value()) {
+        indices.transferFamily = indices.graphicsFamily;
+    }
+    if(!indices.computeFamily.has_value()) {
+        indices.computeFamily = indices.graphicsFamily;
+    }
+
     return indices;
 }
 
@@ -270,7 +412,10 @@ void VkContext::createLogicalDevice() {
     const auto indices = this->findQueueFamilies(m_physicalDevice);
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+    std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.computeFamily.value(), indices.transferFamily.value() };
+    if(indices.presentFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.presentFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for(const auto queueFamily : uniqueQueueFamilies) {
@@ -284,11 +429,127 @@ void VkContext::createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    // 管线统计查询是可选功能, 只在设备支持时开启
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    // 主通道内容由二级命令缓冲执行, 统计查询需要被它们继承
+    deviceFeatures.inheritedQueries = supportedFeatures.inheritedQueries;
+    // 实例化提交时剔除输出的间接绘制命令带有非零的 firstInstance, 没有该功能时驱动可以把它当作 0
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+    const auto isExtensionSupported = [&](const char *extension) {
+        return std::any_of(availableExtensions.begin(), availableExtensions.end(), [&](const VkExtensionProperties &property) {
+            return strcmp(property.extensionName, extension) == 0;
+        });
+    };
+    auto deviceExtensions = this->getRequiredDeviceExtensions();
+    for(const auto *extension : OPTIONAL_DEVICE_EXTENSION) {
+        if(isExtensionSupported(extension)) deviceExtensions.push_back(extension);
+    }
+
+    VkPhysicalDeviceVulkan13Features vulkan13Features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .pNext = nullptr,
+        .synchronization2 = VK_TRUE,
+        .dynamicRendering = VK_TRUE,
+    };
+
+    // bindless 描述符堆: 运行时长度的描述符数组, 允许空槽位, 绑定后仍可更新未使用的槽位
+    VkPhysicalDeviceVulkan12Features vulkan12Features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &vulkan13Features,
+    };
+    vulkan12Features.descriptorIndexing = VK_TRUE;
+    vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+
+    // 扩展的特性结构只有扩展可用时才能加入查询链
+    void *pSupportedNext = nullptr;
+    const auto chainSupported = [&](auto &features, const char *extension) {
+        if(isExtensionSupported(extension)) {
+            features.pNext = pSupportedNext;
+            pSupportedNext = &features;
+        }
+    };
+    // 图形管线库: 着色器部分预先编译, 快速链接出过渡管线
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT supportedPipelineLibraryFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+    };
+    chainSupported(supportedPipelineLibraryFeatures, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    // present id + present wait: 等到某一帧真正显示, 用于帧节奏和延迟统计
+    VkPhysicalDevicePresentIdFeaturesKHR supportedPresentIdFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+    };
+    chainSupported(supportedPresentIdFeatures, VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    VkPhysicalDevicePresentWaitFeaturesKHR supportedPresentWaitFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+    };
+    chainSupported(supportedPresentWaitFeatures, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    // GPU 剔除需要 vkCmdDrawIndexedIndirectCount, 设备不支持时退回 CPU 剔除
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = pSupportedNext,
+    };
+    VkPhysicalDeviceFeatures2 supportedFeatures2 {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &supportedVulkan12Features,
+    };
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures2);
+    vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    if(m_settings.gpuCulling && supportedVulkan12Features.drawIndirectCount != VK_TRUE) {
+        Log::Warning("drawIndirectCount is not supported, falling back to CPU culling");
+        this->disableGpuCulling();
+    }
+    else if(m_settings.gpuCulling && supportedFeatures.drawIndirectFirstInstance != VK_TRUE) {
+        Log::Warning("drawIndirectFirstInstance is not supported, falling back to CPU culling");
+        this->disableGpuCulling();
+    }
+
+    m_pipelineLibraryEnabled = m_settings.pipelineLibrary && supportedPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE;
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibraryFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT,
+        .pNext = nullptr,
+        .graphicsPipelineLibrary = VK_TRUE,
+    };
+    if(m_pipelineLibraryEnabled) {
+        pipelineLibraryFeatures.pNext = vulkan13Features.pNext;
+        vulkan13Features.pNext = &pipelineLibraryFeatures;
+    }
+
+    m_presentWaitEnabled = !m_settings.headless && supportedPresentIdFeatures.presentId == VK_TRUE &&
+        supportedPresentWaitFeatures.presentWait == VK_TRUE;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+        .pNext = nullptr,
+        .presentId = VK_TRUE,
+    };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+        .pNext = &presentIdFeatures,
+        .presentWait = VK_TRUE,
+    };
+    if(m_presentWaitEnabled) {
+        presentIdFeatures.pNext = vulkan13Features.pNext;
+        vulkan13Features.pNext = &presentWaitFeatures;
+        deviceExtensions.insert(deviceExtensions.end(), PRESENT_WAIT_DEVICE_EXTENSION.begin(), PRESENT_WAIT_DEVICE_EXTENSION.end());
+    }
 
     VkDeviceCreateInfo createInfo {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .pNext = nullptr,
+        .pNext = &vulkan12Features,
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
 
@@ -298,23 +559,277 @@ void VkContext::createLogicalDevice() {
 #else
 
 #endif
-        .enabledExtensionCount = static_cast<uint32_t>(REQUIRE_DEVICE_EXTENSION.size()),
-        .ppEnabledExtensionNames = REQUIRE_DEVICE_EXTENSION.data(),
+        .enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
+        .ppEnabledExtensionNames = deviceExtensions.data(),
         .pEnabledFeatures = &deviceFeatures,
     };
 
     VkResult result = vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device);
     //LOG_IF(ERROR, result != VK_SUCCESS) << "failed to create logical device!";
     Log::ErrorIf(result != VK_SUCCESS, "failed to create logical device!");
+    m_enabledFeatures = deviceFeatures;
+    m_enabledDeviceExtensions = { deviceExtensions.begin(), deviceExtensions.end() };
+    if(m_presentWaitEnabled) {
+        m_waitForPresent = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR");
+        m_presentWaitEnabled = m_waitForPresent != nullptr;
+    }
+    if(!m_settings.headless) Log::Info("Present wait: {}", m_presentWaitEnabled ? "enabled" : "unavailable, frame pacing falls back to GPU completion");
+
+    this->createQueues(indices);
+}
+
+/**
+ * 每个队列族只创建一个队列, 多个用途落在同一队列族时共享同一个 Queue 对象 (以及它的提交锁)
+ * @param indices
+ */
+void VkContext::createQueues(const QueueFamilyIndices &indices) {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const auto getQueue = [&](uint32_t familyIndex, const char *name) {
+        for(const auto &queue : m_queues) {
+            if(queue->GetFamilyIndex() == familyIndex) return queue.get();
+        }
+        m_queues.push_back(std::make_unique<Queue>(m_device, familyIndex, queueFamilies[familyIndex].queueFlags, name));
+        return m_queues.back().get();
+    };
+    m_graphicsQueue = getQueue(indices.graphicsFamily.value(), "graphics");
+    m_computeQueue = getQueue(indices.computeFamily.value(), "async compute");
+    m_transferQueue = getQueue(indices.transferFamily.value(), "transfer");
+    if(indices.presentFamily.has_value()) {
+        m_presentQueue = getQueue(indices.presentFamily.value(), "present");
+    }
+
+    for(const auto &queue : m_queues) {
+        Log::Info("Queue family {}: {}", queue->GetFamilyIndex(), queue->GetName());
+    }
+    if(m_settings.asyncCompute && m_computeQueue == m_graphicsQueue) {
+        Log::Warning("No dedicated compute queue family, culling runs on the graphics queue");
+        m_settings.asyncCompute = false;
+    }
+}
 
-    vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
-    vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+bool VkContext::isDeviceExtensionEnabled(const char *extension) const {
+    return m_enabledDeviceExtensions.contains(extension);
+}
+
+void VkContext::createMemoryAllocator() {
+    m_memoryAllocator = std::make_unique<MemoryAllocator>(m_instance, m_physicalDevice, m_device,
+        this->isDeviceExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME));
+}
+
+void VkContext::createUploadManager() {
+    const auto indices = this->findQueueFamilies(m_physicalDevice);
+    m_uploadManager = std::make_unique<UploadManager>(m_device, *m_memoryAllocator, *m_transferQueue,
+        indices.graphicsFamily.value(), m_settings.framesInFlight);
+}
+
+void VkContext::createRenderGraph() {
+    m_renderGraph = std::make_unique<RenderGraph>(m_device, *m_memoryAllocator, m_graphicsQueue->GetFamilyIndex());
+    if(m_settings.asyncCompute) {
+        m_computeGraph = std::make_unique<RenderGraph>(m_device, *m_memoryAllocator, m_computeQueue->GetFamilyIndex());
+    }
+}
+
+void VkContext::createBindlessHeap() {
+    m_bindlessHeap = std::make_unique<BindlessHeap>(m_device, m_physicalDevice);
+}
+
+/**
+ * 未指定实例数时只有默认三角形 (一个单位实例); 否则生成压力测试场景, 实例化模式下每个网格一个绘制项,
+ * 非实例化模式下每个实例一个绘制项, 两种模式绘制的内容完全相同
+ */
+void VkContext::createMeshes() {
+    StressScene scene;
+    if(m_settings.sceneInstances == 0) {
+        scene.meshes.push_back({
+            .vertices = {
+                { .position = { 0.0f, -0.5f, 0.0f }, .color = { 1.0f, 0.0f, 0.0f } },
+                { .position = { 0.5f, 0.5f, 0.0f }, .color = { 0.0f, 1.0f, 0.0f } },
+                { .position = { -0.5f, 0.5f, 0.0f }, .color = { 0.0f, 0.0f, 1.0f } },
+            },
+            .indices = { 0, 1, 2 },
+        });
+        scene.instances.emplace_back();
+        scene.instanceMeshes.push_back(0);
+    }
+    else {
+        scene = StressScene::Generate(m_settings.sceneMeshes, m_settings.sceneInstances);
+        Log::Info("Stress scene: {} instances of {} meshes, {} submission", scene.instances.size(), scene.meshes.size(),
+            m_settings.instancedSubmission ? "instanced" : "non-instanced");
+    }
+
+    for(const auto &meshData : scene.meshes) {
+        m_meshes.push_back(std::make_unique<Mesh>(*m_memoryAllocator, *m_uploadManager, meshData.vertices, meshData.indices));
+    }
+
+    const auto instanceBytes = scene.instances.size() * sizeof(InstanceData);
+    m_instanceBuffer = m_memoryAllocator->CreateBuffer({
+        .size = instanceBytes,
+        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .movable = true,
+    });
+    m_uploadManager->UploadBuffer(*m_instanceBuffer, 0, scene.instances.data(), instanceBytes,
+        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    m_instanceBufferHandle = m_bindlessHeap->RegisterStorageBuffer(m_instanceBuffer->GetHandle());
+
+    for(uint32_t first = 0; first < scene.instances.size();) {
+        const auto meshIndex = scene.instanceMeshes[first];
+        const auto *mesh = m_meshes[meshIndex].get();
+        auto last = first;
+        while(last < scene.instances.size() && scene.instanceMeshes[last] == meshIndex) {
+            last++;
+        }
+
+        if(m_settings.instancedSubmission) {
+            // 所有实例包围球的外接球: 以球心包围盒的中心为球心
+            glm::vec3 minimum(std::numeric_limits<float>::max());
+            glm::vec3 maximum(std::numeric_limits<float>::lowest());
+            for(auto i = first; i < last; i++) {
+                const auto sphere = StressScene::TransformSphere(mesh->GetBoundingSphere(), scene.instances[i]);
+                minimum = glm::min(minimum, glm::vec3(sphere));
+                maximum = glm::max(maximum, glm::vec3(sphere));
+            }
+            const auto center = (minimum + maximum) * 0.5f;
+            float radius = 0.0f;
+            for(auto i = first; i < last; i++) {
+                const auto sphere = StressScene::TransformSphere(mesh->GetBoundingSphere(), scene.instances[i]);
+                radius = std::max(radius, glm::length(glm::vec3(sphere) - center) + sphere.w);
+            }
+            m_drawList.push_back({ .mesh = mesh, .boundingSphere = glm::vec4(center, radius), .instanceCount = last - first, .firstInstance = first });
+        }
+        else {
+            for(auto i = first; i < last; i++) {
+                m_drawList.push_back({
+                    .mesh = mesh,
+                    .boundingSphere = StressScene::TransformSphere(mesh->GetBoundingSphere(), scene.instances[i]),
+                    .instanceCount = 1,
+                    .firstInstance = i
+                });
+            }
+        }
+        first = last;
+    }
+}
+
+/**
+ * 只创建剔除器并开始编译管线; 对象数据在 createCullObjects 中上传, 管线创建失败时还可以干净地退回 CPU 剔除
+ */
+void VkContext::createGpuCulling() {
+    if(!m_settings.gpuCulling) {
+        return;
+    }
+
+    ShaderCode cullCode;
+    try {
+        cullCode = this->loadShaderCode("cull.spv");
+    }
+    catch(const std::exception &e) {
+        Log::Warning("cull.spv is not available ({}), falling back to CPU culling", e.what());
+        this->disableGpuCulling();
+        return;
+    }
+
+    const auto *cullQueue = m_computeGraph != nullptr ? m_computeQueue : m_graphicsQueue;
+    m_gpuCulling = std::make_unique<GpuCulling>(m_device, *m_memoryAllocator, *m_uploadManager, *m_bindlessHeap,
+        m_pipelineLayout, cullQueue->GetFamilyIndex(), m_settings.framesInFlight, m_settings.verifyCulling);
+    // 退回 CPU 剔除后热重载仍可能编译出剔除管线, 直接交还给编译器销毁
+    m_cullPipelineTarget = m_pipelineCompiler->RegisterTarget("Cull", [this](VkPipeline pipeline) {
+        return m_gpuCulling != nullptr ? m_gpuCulling->ReplacePipeline(pipeline) : pipeline;
+    });
+    const auto futures = m_pipelineCompiler->CompileCompute(m_cullPipelineTarget, {
+        .name = "Cull",
+        .code = std::move(cullCode),
+    });
+    m_startupPipelines.push_back(futures.usable);
+}
+
+/**
+ * 每个绘制项成为一个剔除对象, 可见时以原来的实例参数绘制
+ */
+void VkContext::createCullObjects() {
+    if(m_gpuCulling == nullptr) {
+        return;
+    }
+
+    std::vector<CullObject> objects;
+    std::vector<const Mesh *> objectMeshes;
+    for(const auto &item : m_drawList) {
+        objects.push_back({
+            .boundingSphere = item.boundingSphere,
+            .command = {
+                .indexCount = item.mesh->GetIndexCount(),
+                .instanceCount = item.instanceCount,
+                .firstIndex = 0,
+                .vertexOffset = 0,
+                .firstInstance = item.firstInstance
+            },
+        });
+        objectMeshes.push_back(item.mesh);
+    }
+    m_gpuCulling->SetObjects(std::move(objects), objectMeshes);
+}
+
+// 只在还没有录制任何帧时调用; 计算队列的命令池保留到析构, 之后不再使用
+void VkContext::disableGpuCulling() {
+    m_gpuCulling.reset();
+    m_computeGraph.reset();
+    m_settings.gpuCulling = false;
+    m_settings.verifyCulling = false;
+    m_settings.asyncCompute = false;
+}
+
+/**
+ * 纹理在 I/O 线程上读取, 在任务系统上解码, 第一帧之后按上传预算逐帧出现, 不阻塞初始化
+ */
+void VkContext::createTextureStreamer() {
+    const auto budget = static_cast<VkDeviceSize>(std::max(m_settings.textureBudgetMB, 1u)) * 1024 * 1024;
+    m_textureStreamer = std::make_unique<TextureStreamer>(m_device, *m_memoryAllocator, *m_uploadManager, *m_bindlessHeap, m_jobSystem, budget);
+    for(const auto &file : m_settings.textureFiles) {
+        m_textureStreamer->Load(file);
+    }
+}
+
+/**
+ * 启动时仍然加载构建时编译好的 .spv, 之后对同一份源码的修改在 I/O 线程上编译, 再交给管线编译器重建并在帧边界换入
+ */
+void VkContext::createShaderHotReload() {
+    if(!m_settings.shaderHotReload) {
+        return;
+    }
+
+    m_shaderHotReload = std::make_unique<ShaderHotReload>(SHADER_SOURCE_DIR, m_jobSystem);
+    m_shaderHotReload->Register("Main", { "shader.vert", "shader.frag" },
+        [this, colorFormat = m_swapChainImageFormat](std::vector<std::vector<uint32_t>> spirv) {
+            m_pipelineCompiler->CompileGraphics(m_mainPipelineTarget, {
+                .name = "Main",
+                .vertexCode = ShaderCode::Own(std::move(spirv[0])),
+                .fragmentCode = ShaderCode::Own(std::move(spirv[1])),
+                .colorFormat = colorFormat,
+            });
+        });
+    if(m_gpuCulling != nullptr) {
+        m_shaderHotReload->Register("Cull", { "cull.comp" }, [this](std::vector<std::vector<uint32_t>> spirv) {
+            m_pipelineCompiler->CompileCompute(m_cullPipelineTarget, { .name = "Cull", .code = ShaderCode::Own(std::move(spirv[0])) });
+        });
+    }
+    m_shaderHotReload->Start();
 }
 
 inline void VkContext::createSurface() {
+    if(m_settings.headless) return;
     m_window->CreateWindowSurface(m_instance, &m_surface);
 }
 
+std::vector<const char*> VkContext::getRequiredDeviceExtensions() const {
+    if(m_settings.headless) {
+        return {};
+    }
+    return REQUIRE_DEVICE_EXTENSION;
+}
+
 bool VkContext::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     uint32_t extensionCount = 0;
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
@@ -322,7 +837,8 @@ bool VkContext::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-    std::set<std::string> requiredExtensions(REQUIRE_DEVICE_EXTENSION.begin(), REQUIRE_DEVICE_EXTENSION.end());
+    const auto deviceExtensions = this->getRequiredDeviceExtensions();
+    std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
     for(const auto &extension : availableExtensions) {
         requiredExtensions.erase(extension.extensionName);
     }
@@ -361,10 +877,21 @@ VkSurfaceFormatKHR VkContext::chooseSwapSurfaceFormat(const std::vector<VkSurfac
     return availableFormats[0];
 }
 
-VkPresentModeKHR VkContext::chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes) {
-    for(const auto &availablePresentMode : availablePresentModes) {
-        if(availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return availablePresentMode;
+/**
+ * FIFO 总是可用, 作为所有模式的最后选择
+ * @param availablePresentModes
+ * @param latencyMode 低延迟模式使用 FIFO: 节奏由显示决定, 配合帧节奏控制不会排队多帧; MAILBOX 虽然不排队, 但被替换的帧白白渲染
+ */
+VkPresentModeKHR VkContext::chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes, LatencyMode latencyMode) {
+    std::vector<VkPresentModeKHR> preferred;
+    switch(latencyMode) {
+        case LatencyMode::eThroughput: preferred = { VK_PRESENT_MODE_MAILBOX_KHR }; break;
+        case LatencyMode::eLowLatency: break;
+        case LatencyMode::eImmediate: preferred = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR }; break;
+    }
+    for(const auto presentMode : preferred) {
+        if(std::find(availablePresentModes.begin(), availablePresentModes.end(), presentMode) != availablePresentModes.end()) {
+            return presentMode;
         }
     }
     return VK_PRESENT_MODE_FIFO_KHR;
@@ -375,7 +902,7 @@ VkExtent2D VkContext::chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilit
         return capabilities.currentExtent;
     }
     else {
-        auto [width, height] = m_window->GetFrameBufferSize();
+        const auto [width, height] = m_framebufferSize;
         VkExtent2D actualExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
         actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
         actualExtent.height = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
@@ -383,13 +910,15 @@ VkExtent2D VkContext::chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilit
     }
 }
 
-void VkContext::createSwapChain() {
+void VkContext::createSwapChain(VkSwapchainKHR oldSwapChain) {
     const auto swapChainSupport = this->querySwapChainSupport(m_physicalDevice);
     const auto surfaceFormat = VkContext::chooseSwapSurfaceFormat(swapChainSupport.formats);
-    const auto presentMode = VkContext::chooseSwapPresentMode(swapChainSupport.presentModes);
+    const auto presentMode = VkContext::chooseSwapPresentMode(swapChainSupport.presentModes, m_settings.latencyMode);
     const auto extent = this->chooseSwapExtent(swapChainSupport.capabilities);
 
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+    // 多一张图像让 CPU 不必等待呈现引擎释放图像, 代价是多排队一帧; 低延迟模式只用最少的图像 (至少两张)
+    const auto extraImages = m_settings.latencyMode == LatencyMode::eThroughput ? 1u : 0u;
+    uint32_t imageCount = std::max(swapChainSupport.capabilities.minImageCount + extraImages, 2u);
     if(swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
         imageCount = swapChainSupport.capabilities.maxImageCount;
     }
@@ -408,7 +937,7 @@ void VkContext::createSwapChain() {
         .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode = presentMode,
         .clipped = VK_TRUE,
-        .oldSwapchain = VK_NULL_HANDLE,
+        .oldSwapchain = oldSwapChain,                                               // 交给驱动复用旧交换链的资源
     };
 
     // 指定在多个队列族使用交换链图像的方式
@@ -433,6 +962,7 @@ void VkContext::createSwapChain() {
 
     m_swapChainImageFormat = surfaceFormat.format;
     m_swapChainExtent = extent;
+    LOG_DEBUG("Swap chain: present mode {}, {} images", static_cast<int>(presentMode), imageCount);
 }
 
 void VkContext::createSwapChainImageViews() {
@@ -465,127 +995,96 @@ void VkContext::createSwapChainImageViews() {
     }
 }
 
-void VkContext::createGraphicsPipeline() {
-    const auto vertShaderCode = VkContext::readFile("../vert.spv");
-    const auto fragShaderCode = VkContext::readFile("../frag.spv");
-
-    const auto vertexShaderModule = this->createShaderModule(vertShaderCode);
-    const auto fragmentShaderModule = this->createShaderModule(fragShaderCode);
-
-    VkPipelineShaderStageCreateInfo vertexShaderStageInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-        .pNext = nullptr,
-        .stage = VK_SHADER_STAGE_VERTEX_BIT,
-        .module = vertexShaderModule,
-        .pName = "main",
-    };
-
-    VkPipelineShaderStageCreateInfo fragmentShaderStageInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-        .pNext = nullptr,
-        .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-        .module = fragmentShaderModule,
-        .pName = "main",
-    };
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = { vertexShaderStageInfo, fragmentShaderStageInfo };
-
-    VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .vertexBindingDescriptionCount = 0,
-        .vertexAttributeDescriptionCount = 0
-    };
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,                                            // 图元类型
-        .primitiveRestartEnable = VK_FALSE
-    };
-
-    VkPipelineViewportStateCreateInfo viewportStateCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .viewportCount = 1,
-        .scissorCount = 1
-    };
-
-    VkPipelineRasterizationStateCreateInfo rasterizationStateCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .depthClampEnable = VK_FALSE,
-        .rasterizerDiscardEnable = VK_FALSE,
-        .polygonMode = VK_POLYGON_MODE_FILL,
-        .cullMode = VK_CULL_MODE_BACK_BIT,
-        .frontFace = VK_FRONT_FACE_CLOCKWISE,
-        .depthBiasEnable = VK_FALSE,
-        .lineWidth = 1.0f
-    };
-
-    VkPipelineMultisampleStateCreateInfo multisampleStateCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
-        .sampleShadingEnable = VK_FALSE
-    };
+/**
+ * headless 模式下用自有的离屏图像代替交换链图像, 每个 in-flight 帧一张
+ */
+void VkContext::createOffscreenImages() {
+    m_swapChainImageFormat = OFFSCREEN_COLOR_FORMAT;
+    m_swapChainExtent = { static_cast<uint32_t>(WINDOW_SIZE.width), static_cast<uint32_t>(WINDOW_SIZE.height) };
 
-    VkPipelineColorBlendAttachmentState colorBlendAttachmentState {
-        .blendEnable = VK_FALSE,
-        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
-    };
+    m_swapChainImages.resize(m_settings.framesInFlight);
+    m_offscreenImages.resize(m_settings.framesInFlight);
+    for(auto i = 0; i < m_swapChainImages.size(); i++) {
+        m_offscreenImages[i] = m_memoryAllocator->CreateImage({
+            .format = m_swapChainImageFormat,
+            .extent = { m_swapChainExtent.width, m_swapChainExtent.height, 1 },
+            .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        });
+        m_swapChainImages[i] = m_offscreenImages[i]->GetHandle();
+    }
+}
 
-    VkPipelineColorBlendStateCreateInfo colorBlendStateCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .logicOpEnable = VK_FALSE,
-        .logicOp = VK_LOGIC_OP_COPY,
-        .attachmentCount = 1,
-        .pAttachments = &colorBlendAttachmentState,
-        .blendConstants = { 0.0, 0.0, 0.0, 0.0 }
-    };
+/**
+ * 每个 in-flight 帧一块常驻映射的主机可见缓冲, 渲染结束后颜色目标拷贝到这里
+ */
+void VkContext::createReadbackBuffers() {
+    const VkDeviceSize size = static_cast<VkDeviceSize>(m_swapChainExtent.width) * m_swapChainExtent.height * 4;
+
+    for(auto &frame : m_frames) {
+        frame.readbackBuffer = m_memoryAllocator->CreateBuffer({
+            .size = size,
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .domain = MemoryDomain::eReadback,
+        });
+    }
+}
 
-    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-    VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .pNext = nullptr,
-        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
-        .pDynamicStates = dynamicStates.data()
-    };
+void VkContext::createPipelineCache() {
+    m_pipelineCache = std::make_unique<PipelineCache>(m_device, m_physicalDevice, PIPELINE_CACHE_FILE);
+}
 
+void VkContext::createPipelineLayout() {
+    // 所有管线共用 bindless 描述符集和同一段推送常量, 资源以下标的形式随推送常量传入
+    const auto setLayout = m_bindlessHeap->GetSetLayout();
+    const auto pushConstantRange = BindlessHeap::GetPushConstantRange();
     VkPipelineLayoutCreateInfo layoutCreateInfo {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .pNext = nullptr,
-        .setLayoutCount = 0,
-        .pushConstantRangeCount = 0
+        .setLayoutCount = 1,
+        .pSetLayouts = &setLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
     };
-    auto result = vkCreatePipelineLayout(m_device, &layoutCreateInfo, nullptr, &m_pipelineLayout);
+    const auto result = vkCreatePipelineLayout(m_device, &layoutCreateInfo, nullptr, &m_pipelineLayout);
     //LOG_IF(ERROR, result != VK_SUCCESS) << "Failed to create pipeline layout!";
     Log::ErrorIf(result != VK_SUCCESS, "Failed to create pipeline layout!");
+}
 
-    VkGraphicsPipelineCreateInfo pipelineCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .pNext = nullptr,
-        .stageCount = 2,
-        .pStages = shaderStages,
-        .pVertexInputState = &vertexInputCreateInfo,
-        .pInputAssemblyState = &inputAssemblyCreateInfo,
-        .pViewportState = &viewportStateCreateInfo,
-        .pRasterizationState = &rasterizationStateCreateInfo,
-        .pMultisampleState = &multisampleStateCreateInfo,
-        .pColorBlendState = &colorBlendStateCreateInfo,
-        .pDynamicState = &dynamicStateCreateInfo,
-        .layout = m_pipelineLayout,
-        .renderPass = m_renderPass,
-        .subpass = 0,
-        .basePipelineHandle = VK_NULL_HANDLE
-    };
-    result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &m_graphicsPipeline);
-    //LOG_IF(ERROR, result != VK_SUCCESS) << "Failed to create graphics pipeline!";
-    Log::ErrorIf(result != VK_SUCCESS, "Failed to create graphics pipeline!");
+/**
+ * 管线作为低优先级任务编译, 与同时进行的其他初始化和之后的帧内任务共用任务系统的工作线程
+ */
+void VkContext::createPipelineCompiler() {
+    m_pipelineCompiler = std::make_unique<PipelineCompiler>(m_device, *m_pipelineCache, m_pipelineLayout, m_pipelineLibraryEnabled, m_jobSystem);
+}
+
+void VkContext::createGraphicsPipeline() {
+    m_mainPipelineTarget = m_pipelineCompiler->RegisterTarget("Main", [this](VkPipeline pipeline) { return std::exchange(m_graphicsPipeline, pipeline); });
+    const auto futures = m_pipelineCompiler->CompileGraphics(m_mainPipelineTarget, {
+        .name = "Main",
+        .vertexCode = this->loadShaderCode("vert.spv"),
+        .fragmentCode = this->loadShaderCode("frag.spv"),
+        .colorFormat = m_swapChainImageFormat,
+    });
+    m_startupPipelines.push_back(futures.usable);
+}
 
-    vkDestroyShaderModule(m_device, vertexShaderModule, nullptr);
-    vkDestroyShaderModule(m_device, fragmentShaderModule, nullptr);
+/**
+ * 管线在编译线程上与其余初始化并行创建, 第一帧之前至少要有可用的过渡管线; 它们在第一帧的 BeginFrame 中换入
+ */
+void VkContext::waitForStartupPipelines() {
+    const auto startTime = std::chrono::steady_clock::now();
+    for(const auto &future : m_startupPipelines) {
+        future.wait();
+    }
+    m_startupPipelines.clear();
+    // 启动管线立即换入, 以便检查它们是否创建成功; 此时还没有帧引用任何管线
+    m_pipelineCompiler->BeginFrame(0, 0);
+    if(m_gpuCulling != nullptr && !m_gpuCulling->HasPipeline()) {
+        Log::Warning("Cull pipeline was not created, falling back to CPU culling");
+        this->disableGpuCulling();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+    Log::Info("Waited {:.3f} ms for startup pipelines", elapsed.count());
 }
 
 std::vector<char> VkContext::readFile(const std::string &fileName) {
@@ -606,121 +1105,302 @@ std::vector<char> VkContext::readFile(const std::string &fileName) {
     return buffer;
 }
 
-VkShaderModule VkContext::createShaderModule(const std::vector<char> &code) {
-    VkShaderModuleCreateInfo createInfo {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .pNext = nullptr,
-        .codeSize = code.size(),
-        .pCode = reinterpret_cast<const uint32_t *>(code.data())
-    };
-
-    VkShaderModule shaderModule;
-    const auto result = vkCreateShaderModule(m_device, &createInfo, nullptr, &shaderModule);
-    Log::ErrorIf(result != VK_SUCCESS, "Failed to create shader module!");
-
-    return shaderModule;
+std::vector<uint32_t> VkContext::readShaderCode(const std::string &fileName) {
+    const auto bytes = VkContext::readFile(fileName);
+    std::vector<uint32_t> code(bytes.size() / sizeof(uint32_t));
+    std::memcpy(code.data(), bytes.data(), code.size() * sizeof(uint32_t));
+    return code;
 }
 
-void VkContext::createRenderPass() {
-    VkAttachmentDescription colorAttachment {
-        .format = m_swapChainImageFormat,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-    };
+/**
+ * 资源包只映射不读取, 打开的开销与包内文件数无关; 没有资源包时 (开发中直接运行 shader.bat 的产物) 退回逐个读取文件
+ */
+void VkContext::createAssetPack() {
+    std::string error;
+    m_assetPack = AssetPack::Open(ASSET_PACK_FILE, error);
+    if(m_assetPack == nullptr) {
+        Log::Warning("Asset pack {} not used ({}), loading loose files", ASSET_PACK_FILE, error);
+        return;
+    }
+    Log::Info("Mapped asset pack {} with {} entries", ASSET_PACK_FILE, m_assetPack->GetEntryCount());
+}
 
-    VkAttachmentReference colorAttachmentReference {
-        .attachment = 0,
-        .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-    };
+/**
+ * 未压缩的条目直接引用映射中的字节, 不复制; 压缩的条目解压到由 ShaderCode 持有的缓冲
+ */
+ShaderCode VkContext::loadShaderCode(const std::string &name) const {
+    const auto *entry = m_assetPack != nullptr ? m_assetPack->Find(name) : nullptr;
+    if(entry == nullptr) {
+        return ShaderCode::Own(VkContext::readShaderCode("../" + name));
+    }
 
-    VkSubpassDescription subpassDescription {
-        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-        .colorAttachmentCount = 1,
-        .pColorAttachments = &colorAttachmentReference
+    auto storage = std::make_shared<std::vector<std::byte>>();
+    const auto bytes = m_assetPack->Read(*entry, *storage);
+    Log::ErrorIf(bytes.empty() || bytes.size() % sizeof(uint32_t) != 0, "Asset pack entry {} is corrupted!", name);
+    return {
+        .words = { reinterpret_cast<const uint32_t *>(bytes.data()), bytes.size() / sizeof(uint32_t) },
+        .owner = storage->empty() ? nullptr : std::move(storage),
     };
-
-    VkRenderPassCreateInfo renderPassCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-        .pNext = nullptr,
-        .attachmentCount = 1,
-        .pAttachments = &colorAttachment,
-        .subpassCount = 1,
-        .pSubpasses = &subpassDescription
-    };
-    const auto result = vkCreateRenderPass(m_device, &renderPassCreateInfo, nullptr, &m_renderPass);
-    //LOG_IF(ERROR, result != VK_SUCCESS) << "Failed to create render pass!";
-}
-
-void VkContext::createFramebuffers() {
-    m_swapChainFrameBuffers.resize(m_swapChainImageViews.size());
-    for(auto i = 0; i < m_swapChainImageViews.size(); i++) {
-        VkImageView attachments [] = { m_swapChainImageViews[i] };
-
-        VkFramebufferCreateInfo framebufferCreateInfo {
-            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass = m_renderPass,
-            .attachmentCount = 1,
-            .pAttachments = attachments,
-            .width = m_swapChainExtent.width,
-            .height = m_swapChainExtent.height,
-            .layers = 1
-        };
-        const auto result = vkCreateFramebuffer(m_device, &framebufferCreateInfo, nullptr, &m_swapChainFrameBuffers[i]);
-        //LOG_IF(ERROR, result != VK_SUCCESS) << "Failed to create framebuffer!";
-    }
 }
 
+/**
+ * 每个 in-flight 帧一个主命令池, 外加每个录制线程一个二级命令池; 帧开始时整池重置, 不需要逐个重置命令缓冲
+ */
 void VkContext::createCommandPool() {
     const auto queueFamilyIndices = this->findQueueFamilies(m_physicalDevice);
 
     VkCommandPoolCreateInfo commandPoolCreateInfo {
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
         .queueFamilyIndex = queueFamilyIndices.graphicsFamily.value()
     };
-    const auto result = vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &m_commandPool);
-    Log::ErrorIf(result != VK_SUCCESS, "Failed to create command pool!");
+    m_frames.resize(m_settings.framesInFlight);
+    for(auto &frame : m_frames) {
+        auto result = vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &frame.commandPool);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create command pool!");
+
+        frame.workerCommands.resize(m_jobSystem.GetWorkerCount());
+        for(auto &workerCommands : frame.workerCommands) {
+            result = vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &workerCommands.commandPool);
+            Log::ErrorIf(result != VK_SUCCESS, "Failed to create worker command pool!");
+        }
+
+        if(m_computeGraph != nullptr) {
+            VkCommandPoolCreateInfo computeCommandPoolCreateInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                .queueFamilyIndex = m_computeQueue->GetFamilyIndex()
+            };
+            result = vkCreateCommandPool(m_device, &computeCommandPoolCreateInfo, nullptr, &frame.computeCommandPool);
+            Log::ErrorIf(result != VK_SUCCESS, "Failed to create compute command pool!");
+        }
+    }
 }
 
 void VkContext::createCommandBuffers() {
-    VkCommandBufferAllocateInfo commandBufferAllocateInfo {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = m_commandPool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1
-    };
-    const auto result = vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &m_commandBuffer);
-    Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate command buffers!");
+    for(auto &frame : m_frames) {
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = frame.commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+        auto result = vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &frame.commandBuffer);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate command buffers!");
+
+        if(frame.computeCommandPool != nullptr) {
+            commandBufferAllocateInfo.commandPool = frame.computeCommandPool;
+            result = vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &frame.computeCommandBuffer);
+            Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate compute command buffers!");
+        }
+    }
+}
+
+void VkContext::createGpuProfiler() {
+    const auto queueFamilyIndices = this->findQueueFamilies(m_physicalDevice);
+    // 主通道的绘制在二级命令缓冲中, 统计查询还需要 inheritedQueries
+    const auto statisticsSupported = m_enabledFeatures.pipelineStatisticsQuery == VK_TRUE && m_enabledFeatures.inheritedQueries == VK_TRUE;
+    m_gpuProfiler = std::make_unique<GpuProfiler>(m_device, m_physicalDevice, queueFamilyIndices.graphicsFamily.value(),
+        m_settings.framesInFlight, statisticsSupported);
 }
 
 void VkContext::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
     VkCommandBufferBeginInfo commandBufferBeginInfo {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
     };
 
     auto result = vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
     //LOG_IF(ERROR, result != VK_SUCCESS);
 
-    VkClearValue clearColor = {.color = { 0.0f, 0.0f, 0.0f, 1.0f }};
-    VkRenderPassBeginInfo renderPassBeginInfo {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = m_renderPass,
-        .framebuffer = m_swapChainFrameBuffers[imageIndex],
-        .renderArea = {
-            .offset = { 0, 0 },
-            .extent = m_swapChainExtent
-        },
-        .clearValueCount = 1,
-        .pClearValues = &clearColor
+    m_gpuProfiler->BeginFrame(commandBuffer, m_currentFrame);
+    m_gpuProfiler->BeginScope(commandBuffer, "Frame");
+    m_uploadManager->RecordAcquireBarriers(commandBuffer, m_graphicsQueue->GetFamilyIndex());
+
+    // 交换链图像由获取信号量保护, 等待发生在颜色输出阶段
+    m_renderGraph->BeginFrame(m_frameValue, m_completedValue);
+    const auto backBuffer = m_renderGraph->ImportTexture("BackBuffer", {
+        .image = m_swapChainImages[imageIndex],
+        .imageView = m_swapChainImageViews[imageIndex],
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .initialStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .finalUsage = m_settings.headless ? ResourceUsage::eNone : ResourceUsage::ePresent,
+    });
+
+    GpuCulling::FrameOutputs culling;
+    if(m_computeGraph != nullptr) {
+        // 剔除 pass 进入计算帧图, 主帧图只获取其输出的所有权
+        m_computeGraph->BeginFrame(m_frameValue, m_completedValue);
+        culling = m_gpuCulling->AddPasses(*m_computeGraph, *m_renderGraph, m_currentFrame, Frustum::FromMatrix(m_viewProjection));
+        this->recordComputeCommandBuffer(m_frames[m_currentFrame].computeCommandBuffer);
+    }
+    else if(m_gpuCulling != nullptr) {
+        culling = m_gpuCulling->AddPasses(*m_renderGraph, *m_renderGraph, m_currentFrame, Frustum::FromMatrix(m_viewProjection));
+    }
+
+    m_renderGraph->AddPass("MainPass", [&](RenderGraphBuilder &builder) {
+        builder.Write(backBuffer, ResourceUsage::eColorAttachment);
+        if(culling.drawBuffer.IsValid()) {
+            builder.Read(culling.drawBuffer, ResourceUsage::eIndirectBuffer);
+            builder.Read(culling.countBuffer, ResourceUsage::eIndirectBuffer);
+        }
+    }, [this, backBuffer](VkCommandBuffer cmd) {
+        GpuProfileScope mainPassScope(m_gpuProfiler.get(), cmd, "MainPass", true);
+        VkRenderingAttachmentInfo colorAttachment {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = m_renderGraph->GetImageView(backBuffer),
+            .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .resolveMode = VK_RESOLVE_MODE_NONE,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue = {.color = { 0.0f, 0.0f, 0.0f, 1.0f }}
+        };
+        VkRenderingInfo renderingInfo {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+            .flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT,
+            .renderArea = {
+                .offset = { 0, 0 },
+                .extent = m_swapChainExtent
+            },
+            .layerCount = 1,
+            .viewMask = 0,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachment
+        };
+        const auto secondaryCommandBuffers = this->recordDrawCommands();
+        vkCmdBeginRendering(cmd, &renderingInfo);
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+        vkCmdEndRendering(cmd);
+    });
+
+    if(m_settings.headless) {
+        const auto &frame = m_frames[m_currentFrame];
+        const auto readbackBuffer = m_renderGraph->ImportBuffer("ReadbackBuffer", {
+            .buffer = frame.readbackBuffer->GetHandle(),
+            .finalUsage = ResourceUsage::eHostRead,
+        });
+        m_renderGraph->AddPass("Readback", [&](RenderGraphBuilder &builder) {
+            builder.Read(backBuffer, ResourceUsage::eTransferSrc);
+            builder.Write(readbackBuffer, ResourceUsage::eTransferDst);
+        }, [this, imageIndex](VkCommandBuffer cmd) {
+            GpuProfileScope readbackScope(m_gpuProfiler.get(), cmd, "Readback");
+            VkBufferImageCopy region {
+                .bufferOffset = 0,
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = 0,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+                },
+                .imageOffset = { 0, 0, 0 },
+                .imageExtent = { m_swapChainExtent.width, m_swapChainExtent.height, 1 }
+            };
+            vkCmdCopyImageToBuffer(cmd, m_swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                m_frames[m_currentFrame].readbackBuffer->GetHandle(), 1, &region);
+        });
+    }
+
+    m_renderGraph->Compile();
+    m_renderGraph->Execute(commandBuffer);
+
+    m_gpuProfiler->EndScope(commandBuffer);
+
+    result = vkEndCommandBuffer(commandBuffer);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to record command buffer!");
+}
+
+void VkContext::recordComputeCommandBuffer(VkCommandBuffer commandBuffer) {
+    VkCommandBufferBeginInfo commandBufferBeginInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
+    m_uploadManager->RecordAcquireBarriers(commandBuffer, m_computeQueue->GetFamilyIndex());
+
+    m_computeGraph->Compile();
+    m_computeGraph->Execute(commandBuffer);
+
+    const auto result = vkEndCommandBuffer(commandBuffer);
+    Log::ErrorIf(result != VK_SUCCESS, "Failed to record compute command buffer!");
+}
+
+/**
+ * 把绘制列表切成连续的片段, 由录制线程各自录制到二级命令缓冲; 按片段顺序返回, 保持绘制顺序不变
+ * @param imageIndex
+ * @return
+ */
+std::vector<VkCommandBuffer> VkContext::recordDrawCommands() {
+    auto &frame = m_frames[m_currentFrame];
+    // GPU 剔除时只有少量间接绘制, 单个二级命令缓冲即可
+    const auto drawCount = m_gpuCulling != nullptr ? 0 : m_drawList.size();
+    const auto frustum = Frustum::FromMatrix(m_viewProjection);
+    const auto sliceCount = std::clamp<size_t>((drawCount + MIN_DRAWS_PER_SLICE - 1) / MIN_DRAWS_PER_SLICE, 1, m_jobSystem.GetWorkerCount());
+
+    // 在动态渲染实例内执行的二级命令缓冲需要声明与之一致的附件格式
+    const VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &m_swapChainImageFormat,
+        .depthAttachmentFormat = VK_FORMAT_UNDEFINED,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    };
+    const VkCommandBufferInheritanceInfo inheritanceInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &inheritanceRenderingInfo,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .pipelineStatistics = m_gpuProfiler->GetActiveStatisticFlags()
     };
-    vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+    std::vector<VkCommandBuffer> commandBuffers(sliceCount);
+    m_jobSystem.ParallelFor(sliceCount, [&](size_t slice, size_t worker) {
+        const auto commandBuffer = this->acquireSecondaryCommandBuffer(frame.workerCommands[worker]);
+        VkCommandBufferBeginInfo beginInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = &inheritanceInfo
+        };
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        this->recordDrawSlice(commandBuffer, drawCount * slice / sliceCount, drawCount * (slice + 1) / sliceCount, frustum);
+        const auto result = vkEndCommandBuffer(commandBuffer);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to record secondary command buffer!");
+        commandBuffers[slice] = commandBuffer;
+    });
+    return commandBuffers;
+}
+
+/**
+ * 只在所属录制线程上调用, 命令池不需要额外加锁
+ */
+VkCommandBuffer VkContext::acquireSecondaryCommandBuffer(WorkerCommands &workerCommands) {
+    if(workerCommands.usedCount == workerCommands.secondaryCommandBuffers.size()) {
+        VkCommandBufferAllocateInfo allocateInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = workerCommands.commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1
+        };
+        VkCommandBuffer commandBuffer = nullptr;
+        const auto result = vkAllocateCommandBuffers(m_device, &allocateInfo, &commandBuffer);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to allocate secondary command buffer!");
+        workerCommands.secondaryCommandBuffers.push_back(commandBuffer);
+    }
+    return workerCommands.secondaryCommandBuffers[workerCommands.usedCount++];
+}
+
+void VkContext::recordDrawSlice(VkCommandBuffer commandBuffer, size_t begin, size_t end, const Frustum &frustum) {
+    // 动态状态和描述符集不会从主命令缓冲继承, 每个二级命令缓冲都要重新设置
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+    m_bindlessHeap->Bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout);
+    // 与 shader.vert 的推送常量块一致
+    const uint32_t instanceBuffer = m_instanceBufferHandle.index;
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(instanceBuffer), &instanceBuffer);
 
     VkViewport viewport {
         .x = 0.0f,
@@ -738,12 +1418,37 @@ void VkContext::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imag
     };
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    if(m_gpuCulling != nullptr) {
+        m_gpuCulling->RecordDraws(commandBuffer, m_currentFrame);
+        return;
+    }
 
-    vkCmdEndRenderPass(commandBuffer);
+    // CPU 剔除, 与 GPU 剔除使用同样的判定, 也是校验 GPU 结果时的参考
+    const Mesh *boundMesh = nullptr;
+    for(auto i = begin; i < end; i++) {
+        const auto &item = m_drawList[i];
+        if(!frustum.IsSphereVisible(item.boundingSphere)) {
+            continue;
+        }
+        if(item.mesh != boundMesh) {
+            item.mesh->Bind(commandBuffer);
+            boundMesh = item.mesh;
+        }
+        item.mesh->Draw(commandBuffer, item.instanceCount, item.firstInstance);
+    }
+}
 
-    result = vkEndCommandBuffer(commandBuffer);
-    Log::ErrorIf(result != VK_SUCCESS, "Failed to record command buffer!");
+void VkContext::resetFrameCommandPools(FrameData &frame) {
+    vkResetCommandPool(m_device, frame.commandPool, 0);
+    if(frame.computeCommandPool != nullptr) {
+        vkResetCommandPool(m_device, frame.computeCommandPool, 0);
+    }
+    for(auto &workerCommands : frame.workerCommands) {
+        if(workerCommands.usedCount > 0) {
+            vkResetCommandPool(m_device, workerCommands.commandPool, 0);
+            workerCommands.usedCount = 0;
+        }
+    }
 }
 
 void VkContext::createSyncObjects() {
@@ -751,55 +1456,343 @@ void VkContext::createSyncObjects() {
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
     };
 
-    VkFenceCreateInfo fenceCreateInfo {
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT
+    // 帧槽位的复用和跨队列等待都使用队列自己的时间线信号量, 这里只剩交换链获取需要的二值信号量
+    for(auto &frame : m_frames) {
+        const auto result = vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &frame.imageAvailableSemaphore);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create synchronization objects for a frame!");
+    }
+
+    this->createRenderFinishedSemaphores();
+}
+
+/**
+ * 呈现引擎可能仍在等待上一次提交的信号量, 所以按交换链图像而不是按帧分配
+ */
+void VkContext::createRenderFinishedSemaphores() {
+    VkSemaphoreCreateInfo semaphoreCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
     };
 
-    const auto result1 = vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &m_imageAvailableSemaphore);
-    const auto result2 = vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &m_renderFinishedSemaphore);
-    const auto result3 = vkCreateFence(m_device, &fenceCreateInfo, nullptr, &m_inFlightFence);
-    Log::ErrorIf(result1 != VK_SUCCESS || result2 != VK_SUCCESS || result3 != VK_SUCCESS, 
-        "Failed to create synchronization objects for a frame!");
+    m_renderFinishedSemaphores.resize(m_swapChainImages.size());
+    for(auto &semaphore : m_renderFinishedSemaphores) {
+        const auto result = vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &semaphore);
+        Log::ErrorIf(result != VK_SUCCESS, "Failed to create synchronization objects for a frame!");
+    }
+}
+
+/**
+ * 以当前交换链为 oldSwapchain 创建新的交换链, 旧交换链连同图像视图和信号量
+ * 一起挂到退役列表, 由 destroyRetiredSwapChains 在引用它们的帧完成后销毁
+ * @return 窗口最小化时返回 false, 本帧跳过
+ */
+bool VkContext::recreateSwapChain() {
+    if(m_framebufferSize.width == 0 || m_framebufferSize.height == 0) {
+        return false;
+    }
+
+    m_retiredSwapChains.push_back({
+        .swapChain = m_swapChain,
+        .imageViews = std::move(m_swapChainImageViews),
+        .renderFinishedSemaphores = std::move(m_renderFinishedSemaphores),
+    });
+    m_swapChainImageViews.clear();
+    m_renderFinishedSemaphores.clear();
+
+    this->createSwapChain(m_swapChain);
+    this->createSwapChainImageViews();
+    this->createRenderFinishedSemaphores();
+    // present id 属于旧交换链, 之后无法再在新交换链上等待; 旧交换链上没确认的帧不计入延迟统计
+    std::erase_if(m_pendingPresents, [](const PendingPresent &pending) { return pending.presentId != 0; });
+
+    m_swapChainOutOfDate = false;
+    LOG_DEBUG("Swap chain recreated at frame {}: {}x{}, {} retired swap chains pending",
+        m_frameNumber, m_swapChainExtent.width, m_swapChainExtent.height, m_retiredSwapChains.size());
+    return true;
+}
+
+/**
+ * retireValue 是退役后第一帧的图形提交; 它完成时引用旧交换链的帧都已完成, 并且在它之前
+ * 入队的呈现操作已经执行过对旧信号量的等待
+ * @param force 为 true 时不检查时间线, 仅在设备空闲后调用
+ */
+void VkContext::destroyRetiredSwapChains(bool force) {
+    const auto completedValue = m_graphicsQueue->GetCompletedValue();
+    std::erase_if(m_retiredSwapChains, [&](RetiredSwapChain &retired) {
+        if(!force && (retired.retireValue == 0 || completedValue < retired.retireValue)) {
+            return false;
+        }
+        for(auto semaphore : retired.renderFinishedSemaphores) {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+        for(auto imageView : retired.imageViews) {
+            vkDestroyImageView(m_device, imageView, nullptr);
+        }
+        vkDestroySwapchainKHR(m_device, retired.swapChain, nullptr);
+        return true;
+    });
 }
 
-void VkContext::DrawFrame() {
-    vkWaitForFences(m_device, 1, &m_inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(m_device, 1, &m_inFlightFence);
+/**
+ * 在渲染线程上调用, 只读取快照而不访问窗口
+ * @param packet 主线程为本帧准备的快照
+ */
+void VkContext::DrawFrame(const RenderPacket &packet) {
+    auto &frame = m_frames[m_currentFrame];
+    m_viewProjection = packet.viewProjection;
+    m_framebufferSize = packet.framebufferSize;
+    // 标记保留到重建成功, 最小化期间的快照不会丢失它
+    m_swapChainOutOfDate = m_swapChainOutOfDate || packet.resized;
+
+    // 每次调用返回距上一次调用的毫秒数, 用于分段计时
+    auto stageStart = std::chrono::steady_clock::now();
+    const auto lap = [&stageStart]() {
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double, std::milli> elapsed = now - stageStart;
+        stageStart = now;
+        return elapsed.count();
+    };
+    m_lastFrameTimings = {};
+
+    // 只等待复用同一槽位的那一帧在图形时间线上的值, 其余 in-flight 帧继续在 GPU 上执行
+    m_graphicsQueue->Wait(frame.submittedValue);
+    m_lastFrameTimings.fenceWaitMs = lap();
+    this->destroyRetiredSwapChains(false);
+    if(m_gpuCulling != nullptr) {
+        m_gpuCulling->VerifyFrame(m_currentFrame);
+    }
 
-    uint32_t imageIndex;
-    vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX, m_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    // headless 模式下每个帧槽位固定使用自己的离屏图像
+    uint32_t imageIndex = m_currentFrame;
+    if(!m_settings.headless) {
+        if(m_swapChainOutOfDate && !this->recreateSwapChain()) {
+            return;
+        }
 
-    vkResetCommandBuffer(m_commandBuffer, 0);
-    recordCommandBuffer(m_commandBuffer, imageIndex);
+        lap();
+        const auto acquireResult = vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+        if(acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+            // 信号量没有被触发, 槽位也没有新的提交, 下一帧重建交换链后直接复用
+            m_swapChainOutOfDate = true;
+            return;
+        }
+        // VK_SUBOPTIMAL_KHR 时图像仍然可用, 本帧照常呈现, 呈现后再重建
+        Log::ErrorIf(acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR, "Failed to acquire swap chain image!");
+        m_swapChainOutOfDate = acquireResult == VK_SUBOPTIMAL_KHR;
+        m_lastFrameTimings.acquireMs = lap();
+    }
 
-    VkSemaphore waitSenmaphores[] = { m_imageAvailableSemaphore };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphore };
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = waitSenmaphores,
-        .pWaitDstStageMask = waitStages,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &m_commandBuffer,
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores = signalSemaphores
+    lap();
+    // 先把积累的上传提交到传输队列, 本帧命令缓冲开头获取其所有权, 图形提交等待其时间线值
+    m_textureStreamer->RecordUploads();
+    const auto upload = m_uploadManager->Submit();
+
+    // 传输队列可能与图形队列共用, 上传提交之后图形队列的下一个值才是本帧的值;
+    // 异步计算的提交总在同一帧的图形提交之前完成, 计算帧图也以图形时间线判断资源是否可以回收
+    m_frameValue = m_graphicsQueue->GetSubmittedValue() + 1;
+    m_completedValue = m_graphicsQueue->GetCompletedValue();
+    m_memoryAllocator->SetCurrentFrameIndex(static_cast<uint32_t>(m_frameNumber));
+    m_bindlessHeap->BeginFrame(m_frameValue, m_completedValue);
+    m_pipelineCompiler->BeginFrame(m_frameValue, m_completedValue);
+    m_textureStreamer->BeginFrame(m_frameValue, m_completedValue);
+
+    this->resetFrameCommandPools(frame);
+    recordCommandBuffer(frame.commandBuffer, imageIndex);
+    m_lastFrameTimings.recordMs = lap();
+
+    std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+    if(!m_settings.headless) {
+        waitSemaphores.push_back({
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = frame.imageAvailableSemaphore,
+            .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        });
+    }
+    // 时间线值可以被多个提交等待: 计算和图形各自只在用到上传数据的阶段等待
+    const auto &uploadQueue = m_uploadManager->GetQueue();
+    if(upload.value != 0 && &uploadQueue != m_graphicsQueue) {
+        waitSemaphores.push_back(uploadQueue.MakeWaitInfo(upload.value, upload.waitStage));
+    }
+    if(m_computeGraph != nullptr) {
+        std::vector<VkSemaphoreSubmitInfo> computeWaitSemaphores;
+        if(upload.value != 0 && &uploadQueue != m_computeQueue) {
+            computeWaitSemaphores.push_back(uploadQueue.MakeWaitInfo(upload.value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+        }
+        const auto computeValue = m_computeQueue->Submit({ &frame.computeCommandBuffer, 1 }, computeWaitSemaphores, {});
+        if(computeValue != 0) {
+            waitSemaphores.push_back(m_computeQueue->MakeWaitInfo(computeValue, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT));
+        }
+    }
+    // 呈现前的布局转换在命令缓冲末尾, 信号量要等全部命令完成
+    VkSemaphoreSubmitInfo signalSemaphore {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = m_renderFinishedSemaphores[imageIndex],
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
     };
 
-    const auto result = vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFence);
+    lap();
+    frame.submittedValue = m_graphicsQueue->Submit({ &frame.commandBuffer, 1 }, waitSemaphores,
+        { &signalSemaphore, m_settings.headless ? 0u : 1u });
+    m_lastFrameTimings.submitMs = lap();
+    if(frame.submittedValue == 0) {
+        // 提交失败时呈现信号量不会被触发, 不能呈现; 本帧按跳过处理
+        return;
+    }
+    for(auto &retired : m_retiredSwapChains) {
+        if(retired.retireValue == 0) {
+            retired.retireValue = frame.submittedValue;
+        }
+    }
 
-    VkSwapchainKHR swapChains[] = { m_swapChain };
-    VkPresentInfoKHR presentInfoKhr {
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = signalSemaphores,
-        .swapchainCount = 1,
-        .pSwapchains = swapChains,
-        .pImageIndices = &imageIndex,
-        .pResults = nullptr
+    PendingPresent pending {
+        .frameValue = frame.submittedValue,
+        .inputTime = packet.inputTime,
     };
-    vkQueuePresentKHR(m_presentQueue, &presentInfoKhr);
+    if(!m_settings.headless) {
+        VkSwapchainKHR swapChains[] = { m_swapChain };
+        // present id 在同一交换链上必须递增, 跨交换链也保持递增即可
+        if(m_presentWaitEnabled) {
+            pending.presentId = ++m_presentId;
+        }
+        VkPresentIdKHR presentId {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+            .pNext = nullptr,
+            .swapchainCount = 1,
+            .pPresentIds = &pending.presentId,
+        };
+        VkPresentInfoKHR presentInfoKhr {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .pNext = m_presentWaitEnabled ? &presentId : nullptr,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &signalSemaphore.semaphore,
+            .swapchainCount = 1,
+            .pSwapchains = swapChains,
+            .pImageIndices = &imageIndex,
+            .pResults = nullptr
+        };
+        const auto presentResult = m_presentQueue->Present(presentInfoKhr);
+        m_lastFrameTimings.presentMs = lap();
+        if(presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+            m_swapChainOutOfDate = true;
+        }
+        else {
+            Log::ErrorIf(presentResult != VK_SUCCESS, "Failed to present swap chain image!");
+        }
+    }
+    if(m_pendingPresents.size() == MAX_PENDING_PRESENTS) {
+        m_pendingPresents.pop_front();
+    }
+    m_pendingPresents.push_back(pending);
+    this->collectPresentedFrames();
+
+    m_currentFrame = (m_currentFrame + 1) % m_settings.framesInFlight;
+    m_frameNumber++;
+    m_lastFrameTimings.rendered = true;
+
+    if(m_settings.gpuProfileInterval > 0 && m_frameNumber % m_settings.gpuProfileInterval == 0) {
+        m_gpuProfiler->LogReport();
+    }
+    if(m_settings.memoryReportInterval > 0 && m_frameNumber % m_settings.memoryReportInterval == 0) {
+        m_memoryAllocator->LogBudgets();
+    }
+    if(m_settings.defragmentInterval > 0 && m_frameNumber % m_settings.defragmentInterval == 0) {
+        m_memoryAllocator->BeginDefragmentation(*m_graphicsQueue);
+    }
+    this->updateDefragmentation();
+}
+
+/**
+ * 帧提交之后推进碎片整理, 本帧等待过的上传对迁移拷贝可见; 迁移的缓冲从下一帧起使用新句柄.
+ * bindless 描述符仍指向旧句柄, 重新注册: 旧槽位由 BindlessHeap 等引用它的帧完成后回收, 旧缓冲由分配器等拷贝完成后销毁
+ */
+void VkContext::updateDefragmentation() {
+    for(const auto *buffer : m_memoryAllocator->UpdateDefragmentation()) {
+        if(buffer == m_instanceBuffer.get()) {
+            m_bindlessHeap->Release(m_instanceBufferHandle);
+            m_instanceBufferHandle = m_bindlessHeap->RegisterStorageBuffer(m_instanceBuffer->GetHandle());
+        }
+    }
+}
+
+/**
+ * 确认已经显示的帧, 记录从处理输入到显示的延迟; 没有 present wait 时以 GPU 完成代替显示.
+ * 低延迟模式下阻塞到本帧完成, 主线程据此安排下一帧的开始时刻; 其他模式只检查不等待, 延迟最多晚一帧被记录
+ */
+void VkContext::collectPresentedFrames() {
+    const auto lowLatency = m_settings.latencyMode == LatencyMode::eLowLatency;
+    if(lowLatency) {
+        // 先等 GPU 完成, 得到本帧从开始到完成的工作时长, 再等显示
+        m_graphicsQueue->Wait(m_pendingPresents.back().frameValue);
+        m_lastFrameTimings.gpuDoneTime = std::chrono::steady_clock::now();
+    }
+
+    while(!m_pendingPresents.empty()) {
+        const auto &pending = m_pendingPresents.front();
+        bool presented = false;
+        if(pending.presentId != 0) {
+            // present id 按顺序完成, 较早的帧已经显示时等待立即返回; 第一次超时后不再等待后面的帧
+            const auto result = m_waitForPresent(m_device, m_swapChain, pending.presentId, lowLatency ? PRESENT_WAIT_TIMEOUT : 0);
+            if(result == VK_TIMEOUT) {
+                break;
+            }
+            // 交换链过期等错误时这一帧不会再被确认, 只丢弃记录
+            presented = result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+        }
+        else if(!m_graphicsQueue->IsCompleted(pending.frameValue)) {
+            break;
+        }
+        else {
+            presented = true;
+        }
+
+        if(presented) {
+            const auto now = std::chrono::steady_clock::now();
+            const std::chrono::duration<double, std::milli> latency = now - pending.inputTime;
+            m_lastFrameTimings.inputToPresentMs = latency.count();
+            if(pending.presentId != 0) {
+                m_lastFrameTimings.displayTime = now;
+            }
+        }
+        m_pendingPresents.pop_front();
+    }
+}
+
+/**
+ * 读回最近一次提交的帧, 返回紧密排列的 RGBA8 像素; 只在 headless 模式下可用
+ * @return
+ */
+std::vector<uint8_t> VkContext::ReadbackFrame() {
+    if(!m_settings.headless || m_frameNumber == 0) {
+        return {};
+    }
+
+    const auto lastFrame = (m_currentFrame + m_settings.framesInFlight - 1) % m_settings.framesInFlight;
+    const auto &frame = m_frames[lastFrame];
+    m_graphicsQueue->Wait(frame.submittedValue);
+
+    const auto size = static_cast<size_t>(m_swapChainExtent.width) * m_swapChainExtent.height * 4;
+    frame.readbackBuffer->Invalidate();
+    const auto *pixels = static_cast<const uint8_t *>(frame.readbackBuffer->GetMappedData());
+    return { pixels, pixels + size };
+}
+
+std::string VkContext::GetDeviceName() const {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    return properties.deviceName;
+}
+
+/**
+ * 设备空闲后调用: 校验最后几帧还没检查的剔除结果
+ * @return GPU 与 CPU 参考结果不一致的帧数, 没有开启校验时为 0
+ */
+uint64_t VkContext::FinishCullingVerification() {
+    if(m_gpuCulling == nullptr || !m_settings.verifyCulling) {
+        return 0;
+    }
+    for(uint32_t i = 0; i < m_settings.framesInFlight; i++) {
+        m_gpuCulling->VerifyFrame(i);
+    }
+    return m_gpuCulling->GetMismatchCount();
 }
 
 void VkContext::WaitIdle() {
@@ -11,21 +11,114 @@
 
 #include <vector>
 #include <memory>
+#include <future>
+#include <chrono>
+#include <deque>
 #include <vulkan/vulkan.h>
 #include <string>
+#include <set>
+#include <glm/glm.hpp>
 #include "../BaseDefine.h"
+#include "BindlessHeap.h"
 
 
 struct QueueFamilyIndices;
 struct SwapChainSupportDetails;
 class Window;
+class GpuProfiler;
+class PipelineCache;
+class MemoryAllocator;
+class GpuBuffer;
+class GpuImage;
+class UploadManager;
+class Mesh;
+class RenderGraph;
+class BindlessHeap;
+class GpuCulling;
+struct Frustum;
+class JobSystem;
+class Queue;
+class ShaderHotReload;
+class PipelineCompiler;
+class TextureStreamer;
+class AssetPack;
+struct ShaderCode;
+struct RenderPacket;
+
+// 最近一次 DrawFrame 各阶段在 CPU 上的耗时, 单位毫秒
+struct FrameTimings {
+    bool rendered = false;                                      // 窗口最小化或交换链过期时本帧被跳过
+    double fenceWaitMs = 0.0;                                   // 等待复用槽位的栅栏
+    double acquireMs = 0.0;
+    double recordMs = 0.0;                                      // 含上传批次提交和命令缓冲录制
+    double submitMs = 0.0;
+    double presentMs = 0.0;
+    double inputToPresentMs = 0.0;                              // 本次调用确认显示的最近一帧从处理输入到显示的延迟, 没有确认的帧时为 0
+    std::chrono::steady_clock::time_point gpuDoneTime;          // 仅低延迟模式: 本帧在 GPU 上完成的时刻
+    std::chrono::steady_clock::time_point displayTime;          // 仅低延迟模式且 present wait 可用: 本帧显示的时刻
+};
 
 class VkContext {
 public:
-    explicit VkContext(std::shared_ptr<Window> &window);
+    VkContext(std::shared_ptr<Window> &window, JobSystem &jobSystem, const RenderSettings &settings);
     ~VkContext();
-    void DrawFrame();
+    void DrawFrame(const RenderPacket &packet);
     void WaitIdle();
+    [[nodiscard]] VkExtent2D GetFrameExtent() const { return m_swapChainExtent; }
+    [[nodiscard]] std::vector<uint8_t> ReadbackFrame();
+    [[nodiscard]] GpuProfiler *GetGpuProfiler() const { return m_gpuProfiler.get(); }
+    [[nodiscard]] MemoryAllocator *GetMemoryAllocator() const { return m_memoryAllocator.get(); }
+    [[nodiscard]] const FrameTimings &GetLastFrameTimings() const { return m_lastFrameTimings; }
+    [[nodiscard]] std::string GetDeviceName() const;
+    [[nodiscard]] uint64_t FinishCullingVerification();
+
+private:
+    // 一个录制线程在一帧内使用的命令池, 帧开始时整池重置, 已分配的二级命令缓冲下一次复用
+    struct WorkerCommands {
+        VkCommandPool commandPool = nullptr;
+        std::vector<VkCommandBuffer> secondaryCommandBuffers;
+        uint32_t usedCount = 0;
+    };
+
+    struct DrawItem {
+        const Mesh *mesh = nullptr;
+        glm::vec4 boundingSphere { 0.0f };                     // 世界空间, 覆盖全部实例
+        uint32_t instanceCount = 1;
+        uint32_t firstInstance = 0;
+    };
+
+    // 每个 in-flight 帧独占的资源, 录制第 N+1 帧时第 N 帧仍可在 GPU 上执行
+    struct FrameData {
+        VkCommandPool commandPool = nullptr;
+        VkCommandBuffer commandBuffer = nullptr;
+        VkSemaphore imageAvailableSemaphore = nullptr;
+        uint64_t submittedValue = 0;                            // 该槽位上一次图形提交的时间线值, 完成后槽位可以复用
+
+        // 仅异步计算: 剔除在计算队列上录制和提交, 图形提交等待其时间线值
+        VkCommandPool computeCommandPool = nullptr;
+        VkCommandBuffer computeCommandBuffer = nullptr;
+
+        // 仅 headless 模式: 渲染结果拷贝到主机可见内存
+        std::unique_ptr<GpuBuffer> readbackBuffer;
+
+        // 按录制线程划分, 下标即 JobSystem 的 workerIndex
+        std::vector<WorkerCommands> workerCommands;
+    };
+
+    // 被替换的交换链及其派生资源, 等引用它们的帧全部完成后再销毁, 避免 vkDeviceWaitIdle
+    struct RetiredSwapChain {
+        VkSwapchainKHR swapChain = nullptr;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkSemaphore> renderFinishedSemaphores;
+        uint64_t retireValue = 0;                               // 退役后第一帧的图形时间线值, 该帧提交前为 0
+    };
+
+    // 已呈现还没确认显示的帧
+    struct PendingPresent {
+        uint64_t presentId = 0;                                 // 0 表示没有 present wait, 以 GPU 完成代替显示
+        uint64_t frameValue = 0;
+        std::chrono::steady_clock::time_point inputTime;
+    };
 
 private:
     void createInstance();
@@ -39,35 +132,77 @@ private:
     [[nodiscard]] bool isDeviceSuitable(VkPhysicalDevice device);
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
     void createLogicalDevice();
+    void createQueues(const QueueFamilyIndices &indices);
+    [[nodiscard]] bool isDeviceExtensionEnabled(const char *extension) const;
+    void createMemoryAllocator();
+    void createUploadManager();
+    void createRenderGraph();
+    void createBindlessHeap();
+    void createMeshes();
+    void createGpuCulling();
+    void createCullObjects();
+    void disableGpuCulling();
+    void createTextureStreamer();
     void createSurface();
-    static bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+    [[nodiscard]] std::vector<const char*> getRequiredDeviceExtensions() const;
+    bool checkDeviceExtensionSupport(VkPhysicalDevice device);
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
     static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats);
-    static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes);
+    static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes, LatencyMode latencyMode);
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities);
-    void createSwapChain();
+    void createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
     void createSwapChainImageViews();
+    bool recreateSwapChain();
+    void destroyRetiredSwapChains(bool force);
+    void collectPresentedFrames();
+    void updateDefragmentation();
+    void createOffscreenImages();
+    void createReadbackBuffers();
+    void createPipelineCache();
+    void createAssetPack();
+    void createPipelineLayout();
+    void createPipelineCompiler();
     void createGraphicsPipeline();
+    void waitForStartupPipelines();
+    void createShaderHotReload();
     static std::vector<char> readFile(const std::string &fileName);
-    VkShaderModule createShaderModule(const std::vector<char> &code);
-    void createRenderPass();
-    void createFramebuffers();
+    static std::vector<uint32_t> readShaderCode(const std::string &fileName);
+    ShaderCode loadShaderCode(const std::string &name) const;
     void createCommandPool();
     void createCommandBuffers();
+    void createGpuProfiler();
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void recordComputeCommandBuffer(VkCommandBuffer commandBuffer);
+    std::vector<VkCommandBuffer> recordDrawCommands();
+    VkCommandBuffer acquireSecondaryCommandBuffer(WorkerCommands &workerCommands);
+    void recordDrawSlice(VkCommandBuffer commandBuffer, size_t begin, size_t end, const Frustum &frustum);
+    void resetFrameCommandPools(FrameData &frame);
     void createSyncObjects();
+    void createRenderFinishedSemaphores();
 
 private:
     std::shared_ptr<Window> m_window;
+    JobSystem &m_jobSystem;                                     // 命令录制, 管线编译和纹理解码共用
+    RenderSettings m_settings;
 
     VkInstance m_instance = nullptr;
     std::vector<const char*> m_requiredExtensions;
     VkDebugUtilsMessengerEXT m_debugMessenger = nullptr;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceFeatures m_enabledFeatures {};
+    std::set<std::string> m_enabledDeviceExtensions;
     VkDevice m_device = nullptr;
-    VkQueue m_graphicsQueue = nullptr;
-    VkQueue m_presentQueue = nullptr;
+    std::vector<std::unique_ptr<Queue>> m_queues;               // 每个用到的队列族一个队列
+    Queue *m_graphicsQueue = nullptr;
+    Queue *m_presentQueue = nullptr;
+    Queue *m_computeQueue = nullptr;                            // 没有独立计算队列族时与 m_graphicsQueue 相同
+    Queue *m_transferQueue = nullptr;                           // 没有独立传输队列族时与 m_graphicsQueue 相同
     VkSurfaceKHR m_surface = nullptr;
+    std::unique_ptr<MemoryAllocator> m_memoryAllocator;
+    std::unique_ptr<UploadManager> m_uploadManager;
+    std::unique_ptr<RenderGraph> m_renderGraph;
+    std::unique_ptr<RenderGraph> m_computeGraph;                // 仅异步计算, 在计算队列上执行
+    std::unique_ptr<BindlessHeap> m_bindlessHeap;
 
 
     VkSwapchainKHR m_swapChain = nullptr;
@@ -75,18 +210,42 @@ private:
     VkFormat m_swapChainImageFormat = VK_FORMAT_UNDEFINED;
     VkExtent2D m_swapChainExtent = { 0, 0 };
     std::vector<VkImageView> m_swapChainImageViews;
+    std::vector<std::unique_ptr<GpuImage>> m_offscreenImages;     // headless 模式下代替交换链图像
 
     VkPipelineLayout m_pipelineLayout = nullptr;
-    VkRenderPass m_renderPass = nullptr;
     VkPipeline m_graphicsPipeline = nullptr;
+    std::vector<std::unique_ptr<Mesh>> m_meshes;
+    std::unique_ptr<GpuBuffer> m_instanceBuffer;                // 全部实例的变换和颜色, 顶点着色器按 gl_InstanceIndex 读取
+    BindlessHandle m_instanceBufferHandle;
+    std::vector<DrawItem> m_drawList;
+    std::unique_ptr<GpuCulling> m_gpuCulling;
+    glm::mat4 m_viewProjection { 1.0f };                        // 每帧从快照复制, 顶点着色器直接输出裁剪空间坐标
+    std::unique_ptr<PipelineCache> m_pipelineCache;
+    std::unique_ptr<AssetPack> m_assetPack;                     // 未压缩的 SPIR-V 直接从映射交给 vkCreateShaderModule, 必须比管线编译器后销毁
+    std::unique_ptr<PipelineCompiler> m_pipelineCompiler;       // 编译好的管线在帧边界直接替换 m_graphicsPipeline 等成员
+    uint32_t m_mainPipelineTarget = 0;
+    uint32_t m_cullPipelineTarget = 0;
+    std::vector<std::shared_future<void>> m_startupPipelines;   // 构造函数末尾等待, 之前的初始化与管线编译并行
+    bool m_pipelineLibraryEnabled = false;
+    std::unique_ptr<ShaderHotReload> m_shaderHotReload;         // 仅开启热重载时创建, 编译出的 SPIR-V 交给 m_pipelineCompiler
+    std::unique_ptr<TextureStreamer> m_textureStreamer;
 
-    std::vector<VkFramebuffer> m_swapChainFrameBuffers;
-    VkCommandPool m_commandPool;
-    VkCommandBuffer m_commandBuffer;
+    std::vector<FrameData> m_frames;
+    std::vector<VkSemaphore> m_renderFinishedSemaphores;           // 按交换链图像索引, 呈现完成前不能复用
+    std::vector<RetiredSwapChain> m_retiredSwapChains;
+    bool m_swapChainOutOfDate = false;
+    bool m_presentWaitEnabled = false;                          // VK_KHR_present_id 和 VK_KHR_present_wait 都可用
+    PFN_vkWaitForPresentKHR m_waitForPresent = nullptr;
+    uint64_t m_presentId = 0;
+    std::deque<PendingPresent> m_pendingPresents;
+    Size m_framebufferSize {};                                  // 构造时由主线程查询, 之后来自每帧的快照
+    uint32_t m_currentFrame = 0;
+    uint64_t m_frameNumber = 0;
+    uint64_t m_frameValue = 0;                                  // 本帧图形提交的时间线值
+    uint64_t m_completedValue = 0;                              // 本帧开始时图形时间线已完成的值
+    FrameTimings m_lastFrameTimings;
 
-    VkSemaphore m_imageAvailableSemaphore = nullptr;
-    VkSemaphore m_renderFinishedSemaphore = nullptr;
-    VkFence m_inFlightFence = nullptr;
+    std::unique_ptr<GpuProfiler> m_gpuProfiler;
 };
 
 
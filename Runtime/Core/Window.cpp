@@ -16,9 +16,18 @@ Window::Window(Size size): m_size(size) {
 void Window::init() {
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
     m_window = glfwCreateWindow(m_size.width, m_size.height, "Vulkan demo", nullptr, nullptr);
     //LOG_ASSERT(google::FATAL) << "Failed to create window!";
+
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetFramebufferSizeCallback(m_window, Window::framebufferResizeCallback);
+}
+
+void Window::framebufferResizeCallback(GLFWwindow *window, int width, int height) {
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(window));
+    self->m_size = { width, height };
+    self->m_resized = true;
 }
 
 GLFWwindow *Window::GetHandle() {
@@ -47,3 +56,8 @@ Size Window::GetFrameBufferSize() {
     glfwGetFramebufferSize(m_window, &width, &height);
     return Size{ width, height };
 }
+
+bool Window::IsMinimized() {
+    const auto [width, height] = this->GetFrameBufferSize();
+    return width == 0 || height == 0;
+}
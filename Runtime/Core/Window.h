@@ -26,13 +26,18 @@ public:
     [[nodiscard]] std::vector<const char*> GetGlfwExtensionInfo() const;
     void CreateWindowSurface(VkInstance instance, VkSurfaceKHR* surface);
     [[nodiscard]] Size GetFrameBufferSize();
+    [[nodiscard]] bool IsMinimized();
+    [[nodiscard]] bool IsResized() const { return m_resized; }
+    void ResetResized() { m_resized = false; }
 
 private:
     void init();
+    static void framebufferResizeCallback(GLFWwindow *window, int width, int height);
 
 private:
     Size m_size;
     GLFWwindow *m_window = nullptr;
+    bool m_resized = false;
 };
 
 
@@ -0,0 +1,280 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <lz4.h>
+#include <lz4hc.h>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+auto AlignUp(uint64_t value, uint64_t alignment) -> uint64_t {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 整个文件只读映射, 页面在第一次访问时才由系统读入
+auto MapFile(const std::filesystem::path &path, uint64_t &size, std::string &error) -> const std::byte * {
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open file";
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        error = "cannot query file size or file is empty";
+        return nullptr;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        error = "cannot create file mapping";
+        return nullptr;
+    }
+    // 视图持有对映射对象的引用, 句柄可以立即关闭
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) {
+        error = "cannot map view of file";
+        return nullptr;
+    }
+    size = static_cast<uint64_t>(fileSize.QuadPart);
+    return static_cast<const std::byte *>(view);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "cannot open file";
+        return nullptr;
+    }
+    struct stat status {};
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        close(file);
+        error = "cannot query file size or file is empty";
+        return nullptr;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED) {
+        error = "cannot map file";
+        return nullptr;
+    }
+    size = static_cast<uint64_t>(status.st_size);
+    return static_cast<const std::byte *>(view);
+#endif
+}
+
+void UnmapFile(const std::byte *data, uint64_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<std::byte *>(data), static_cast<size_t>(size));
+#endif
+}
+
+} // namespace
+
+auto HashAssetName(std::string_view name) -> uint64_t {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// 只检查文件头和各个表的范围, 不逐条目遍历; 条目的数据范围在读取时检查
+auto AssetPack::Open(const std::filesystem::path &path, std::string &error) -> std::unique_ptr<AssetPack> {
+    uint64_t size = 0;
+    const auto *data = MapFile(path, size, error);
+    if (data == nullptr) {
+        return nullptr;
+    }
+
+    std::unique_ptr<AssetPack> pack(new AssetPack());
+    pack->_data = data;
+    pack->_size = size;
+
+    const auto *header = reinterpret_cast<const AssetPackHeader *>(data);
+    if (size < sizeof(AssetPackHeader) || header->magic != ASSET_PACK_MAGIC) {
+        error = "not an asset pack";
+        return nullptr;
+    }
+    if (header->version != ASSET_PACK_VERSION) {
+        error = "unsupported asset pack version " + std::to_string(header->version);
+        return nullptr;
+    }
+    const uint64_t entriesEnd = header->entriesOffset + uint64_t(header->entryCount) * sizeof(AssetPackEntry);
+    if (header->fileSize != size || header->entriesOffset % alignof(AssetPackEntry) != 0 || entriesEnd > size ||
+        header->namesOffset < entriesEnd || header->namesOffset > size) {
+        error = "asset pack is truncated or corrupted";
+        return nullptr;
+    }
+    pack->_header = header;
+    return pack;
+}
+
+AssetPack::~AssetPack() {
+    if (_data != nullptr) {
+        UnmapFile(_data, _size);
+    }
+}
+
+auto AssetPack::GetEntries() const -> std::span<const AssetPackEntry> {
+    return { reinterpret_cast<const AssetPackEntry *>(_data + _header->entriesOffset), _header->entryCount };
+}
+
+auto AssetPack::GetName(const AssetPackEntry &entry) const -> std::string_view {
+    const uint64_t begin = _header->namesOffset + entry.nameOffset;
+    if (begin + entry.nameLength > _size) {
+        return {};
+    }
+    return { reinterpret_cast<const char *>(_data + begin), entry.nameLength };
+}
+
+auto AssetPack::Find(std::string_view name) const -> const AssetPackEntry * {
+    const auto entries = GetEntries();
+    const uint64_t hash = HashAssetName(name);
+    auto it = std::lower_bound(entries.begin(), entries.end(), hash,
+                               [](const AssetPackEntry &entry, uint64_t value) { return entry.nameHash < value; });
+    // 哈希冲突的条目相邻, 逐个比较名字
+    for (; it != entries.end() && it->nameHash == hash; ++it) {
+        if (GetName(*it) == name) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+auto AssetPack::Read(const AssetPackEntry &entry, std::vector<std::byte> &storage) const -> std::span<const std::byte> {
+    storage.clear();
+    if (entry.offset > _size || entry.storedSize > _size - entry.offset) {
+        return {};
+    }
+    const auto *stored = _data + entry.offset;
+
+    switch (entry.compression) {
+    case AssetCompression::eNone:
+        if (entry.storedSize != entry.size) {
+            return {};
+        }
+        return { stored, static_cast<size_t>(entry.size) };
+    case AssetCompression::eLz4: {
+        if (entry.size > uint64_t(LZ4_MAX_INPUT_SIZE) || entry.storedSize > uint64_t(LZ4_MAX_INPUT_SIZE)) {
+            return {};
+        }
+        storage.resize(static_cast<size_t>(entry.size));
+        const int decoded = LZ4_decompress_safe(reinterpret_cast<const char *>(stored), reinterpret_cast<char *>(storage.data()),
+                                                static_cast<int>(entry.storedSize), static_cast<int>(entry.size));
+        if (decoded < 0 || static_cast<uint64_t>(decoded) != entry.size) {
+            storage.clear();
+            return {};
+        }
+        return storage;
+    }
+    }
+    return {};
+}
+
+void AssetPackWriter::Add(std::string name, std::vector<std::byte> data, AssetCompression compression) {
+    PendingEntry entry;
+    entry.name = std::move(name);
+    entry.size = data.size();
+
+    if (compression == AssetCompression::eLz4 && !data.empty() && data.size() <= size_t(LZ4_MAX_INPUT_SIZE)) {
+        const int sourceSize = static_cast<int>(data.size());
+        std::vector<std::byte> compressed(static_cast<size_t>(LZ4_compressBound(sourceSize)));
+        const int compressedSize = LZ4_compress_HC(reinterpret_cast<const char *>(data.data()), reinterpret_cast<char *>(compressed.data()),
+                                                   sourceSize, static_cast<int>(compressed.size()), LZ4HC_CLEVEL_MAX);
+        // 压缩收益太小时保留原始数据, 读取时可以零拷贝
+        if (compressedSize > 0 && static_cast<size_t>(compressedSize) < data.size()) {
+            compressed.resize(static_cast<size_t>(compressedSize));
+            entry.data = std::move(compressed);
+            entry.compression = AssetCompression::eLz4;
+        }
+    }
+    if (entry.compression == AssetCompression::eNone) {
+        entry.data = std::move(data);
+    }
+    _entries.push_back(std::move(entry));
+}
+
+auto AssetPackWriter::Write(const std::filesystem::path &path, std::string &error) const -> bool {
+    // 条目表按哈希排序, 读取端二分查找
+    std::vector<const PendingEntry *> sorted;
+    sorted.reserve(_entries.size());
+    for (const auto &entry : _entries) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const PendingEntry *a, const PendingEntry *b) {
+        const uint64_t hashA = HashAssetName(a->name);
+        const uint64_t hashB = HashAssetName(b->name);
+        return hashA != hashB ? hashA < hashB : a->name < b->name;
+    });
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i]->name == sorted[i - 1]->name) {
+            error = "duplicate asset name " + sorted[i]->name;
+            return false;
+        }
+    }
+
+    AssetPackHeader header {};
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+    header.entriesOffset = sizeof(AssetPackHeader);
+    header.namesOffset = header.entriesOffset + sorted.size() * sizeof(AssetPackEntry);
+
+    std::vector<AssetPackEntry> entries(sorted.size());
+    std::string names;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        entries[i].nameHash = HashAssetName(sorted[i]->name);
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(sorted[i]->name.size());
+        names += sorted[i]->name;
+    }
+    uint64_t offset = AlignUp(header.namesOffset + names.size(), ASSET_PACK_ALIGNMENT);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        entries[i].offset = offset;
+        entries[i].storedSize = sorted[i]->data.size();
+        entries[i].size = sorted[i]->size;
+        entries[i].compression = sorted[i]->compression;
+        offset = AlignUp(offset + entries[i].storedSize, ASSET_PACK_ALIGNMENT);
+    }
+    header.fileSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error = "cannot create " + path.string();
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetPackEntry)));
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    const char padding[ASSET_PACK_ALIGNMENT] = {};
+    uint64_t written = header.namesOffset + names.size();
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        file.write(padding, static_cast<std::streamsize>(entries[i].offset - written));
+        file.write(reinterpret_cast<const char *>(sorted[i]->data.data()), static_cast<std::streamsize>(entries[i].storedSize));
+        written = entries[i].offset + entries[i].storedSize;
+    }
+    file.write(padding, static_cast<std::streamsize>(header.fileSize - written));
+
+    if (!file.good()) {
+        error = "failed writing " + path.string();
+        return false;
+    }
+    return true;
+}
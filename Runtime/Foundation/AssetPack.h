@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PreprocessorDirectives.h"
+
+// 资源包文件布局: [AssetPackHeader][AssetPackEntry 数组, 按名字哈希升序][名字字符串][按 ASSET_PACK_ALIGNMENT 对齐的数据块]
+// 全部字段为小端. 读取时整个文件只读映射到内存, 条目表和数据块都原地访问, 打开的开销与条目数量无关
+constexpr uint32_t ASSET_PACK_MAGIC = 0x4B505356;               // "VSPK"
+constexpr uint32_t ASSET_PACK_VERSION = 1;
+constexpr uint64_t ASSET_PACK_ALIGNMENT = 64;                   // 数据块起始对齐, 满足 SPIR-V 的 4 字节对齐并避免跨缓存行
+
+enum class AssetCompression : uint32_t {
+    eNone = 0,                                                  // 数据块可以直接从映射中使用
+    eLz4 = 1,                                                   // 读取时解压到调用方提供的缓冲
+};
+
+struct AssetPackHeader {
+    uint32_t magic = ASSET_PACK_MAGIC;
+    uint32_t version = ASSET_PACK_VERSION;
+    uint32_t entryCount = 0;
+    uint32_t reserved = 0;
+    uint64_t entriesOffset = 0;
+    uint64_t namesOffset = 0;
+    uint64_t fileSize = 0;
+};
+static_assert(sizeof(AssetPackHeader) == 40);
+
+struct AssetPackEntry {
+    uint64_t nameHash = 0;                                      // HashAssetName(name), 条目表按它排序
+    uint32_t nameOffset = 0;                                    // 相对于 namesOffset
+    uint32_t nameLength = 0;
+    uint64_t offset = 0;                                        // 数据块在文件中的偏移
+    uint64_t storedSize = 0;                                    // 数据块在文件中的字节数
+    uint64_t size = 0;                                          // 解压后的字节数
+    AssetCompression compression = AssetCompression::eNone;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(AssetPackEntry) == 48);
+
+// FNV-1a 64, 名字统一使用 '/' 分隔的相对路径
+auto HashAssetName(std::string_view name) -> uint64_t;
+
+// 只读映射的资源包, 可以在多个线程中同时读取
+class AssetPack {
+public:
+    // 失败时返回空指针, 原因写入 error
+    static auto Open(const std::filesystem::path &path, std::string &error) -> std::unique_ptr<AssetPack>;
+    ~AssetPack();
+    NON_COPYABLE(AssetPack);
+
+    // 二分查找条目表, 只访问被查找的条目所在的页; 不存在时返回空指针
+    auto Find(std::string_view name) const -> const AssetPackEntry *;
+
+    // 未压缩的条目直接返回映射中的字节, 在 AssetPack 销毁前有效, storage 保持为空;
+    // 压缩的条目解压到 storage 并返回它. 数据损坏时返回空 span
+    auto Read(const AssetPackEntry &entry, std::vector<std::byte> &storage) const -> std::span<const std::byte>;
+
+    auto GetEntryCount() const -> uint32_t { return _header->entryCount; }
+    auto GetName(const AssetPackEntry &entry) const -> std::string_view;
+
+private:
+    AssetPack() = default;
+    auto GetEntries() const -> std::span<const AssetPackEntry>;
+
+private:
+    // clang-format off
+    const std::byte                    *_data = nullptr;
+    uint64_t                            _size = 0;
+    const AssetPackHeader              *_header = nullptr;
+    // clang-format on
+};
+
+// 打包工具使用: 收集条目后一次写出
+class AssetPackWriter {
+public:
+    // compression 为 eLz4 但压缩后没有变小时按 eNone 保存
+    void Add(std::string name, std::vector<std::byte> data, AssetCompression compression);
+    auto Write(const std::filesystem::path &path, std::string &error) const -> bool;
+
+    auto GetEntryCount() const -> size_t { return _entries.size(); }
+
+private:
+    struct PendingEntry {
+        std::string name;
+        std::vector<std::byte> data;                            // 已经按 compression 编码
+        uint64_t size = 0;
+        AssetCompression compression = AssetCompression::eNone;
+    };
+
+private:
+    // clang-format off
+    std::vector<PendingEntry>           _entries;
+    // clang-format on
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 固定容量的下标分配器: 优先复用最近释放的下标, 否则从未使用过的区间顺序取出, 分配和释放都是 O(1)
+class IndexAllocator {
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    explicit IndexAllocator(uint32_t capacity) : _capacity(capacity) {}
+
+    // 容量耗尽时返回 INVALID_INDEX
+    auto Allocate() -> uint32_t {
+        if (!_freeList.empty()) {
+            const auto index = _freeList.back();
+            _freeList.pop_back();
+            return index;
+        }
+        return _nextUnused < _capacity ? _nextUnused++ : INVALID_INDEX;
+    }
+
+    void Free(uint32_t index) { _freeList.push_back(index); }
+
+    auto GetCapacity() const -> uint32_t { return _capacity; }
+    auto GetAllocatedCount() const -> uint32_t { return _nextUnused - static_cast<uint32_t>(_freeList.size()); }
+
+private:
+    // clang-format off
+    uint32_t                _capacity   = 0;
+    uint32_t                _nextUnused = 0;
+    std::vector<uint32_t>   _freeList;
+    // clang-format on
+};
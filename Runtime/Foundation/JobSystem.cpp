@@ -0,0 +1,251 @@
+#include "JobSystem.h"
+
+namespace {
+
+constexpr size_t WORKER_DEQUE_CAPACITY = 1024;
+
+// 当前线程所属的调度器和 workerIndex, 非工作线程为空
+thread_local const JobSystem *t_pJobSystem = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+} // namespace
+
+struct JobCounter::Job {
+    JobSystem::JobFunction function;
+    JobCounter *pCounter = nullptr;
+    JobPriority priority = JobPriority::eHigh;
+    bool io = false;
+};
+
+JobSystem::JobSystem(size_t workerThreadCount, size_t ioThreadCount) {
+    _workers.reserve(workerThreadCount);
+    for (size_t i = 0; i < workerThreadCount; ++i) {
+        _workers.push_back(std::make_unique<Worker>(WORKER_DEQUE_CAPACITY));
+    }
+    // 所有队列就绪后再启动线程, 工作线程会窃取彼此的队列
+    for (size_t i = 0; i < workerThreadCount; ++i) {
+        _workers[i]->thread = std::thread([this, i] { WorkerLoop(i + 1); });
+    }
+    for (size_t i = 0; i < ioThreadCount; ++i) {
+        _ioThreads.emplace_back([this] { IoLoop(); });
+    }
+}
+
+// 使用者在销毁前等待自己的任务完成; 此时还留在队列中的任务不再执行
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard wakeLock(_wakeMutex);
+        std::lock_guard ioLock(_ioMutex);
+        _stopping = true;
+    }
+    _wakeCondition.notify_all();
+    _ioCondition.notify_all();
+    for (auto &worker : _workers) {
+        worker->thread.join();
+    }
+    for (auto &thread : _ioThreads) {
+        thread.join();
+    }
+
+    for (auto &worker : _workers) {
+        Job *pJob = nullptr;
+        while (worker->deque.Steal(pJob)) {
+            delete pJob;
+        }
+    }
+    for (auto *queue : { &_highQueue, &_lowQueue, &_ioQueue }) {
+        for (auto *pJob : *queue) {
+            delete pJob;
+        }
+    }
+}
+
+auto JobSystem::GetWorkerIndex() const -> size_t {
+    return t_pJobSystem == this ? t_workerIndex : 0;
+}
+
+void JobSystem::Run(JobFunction function, JobCounter *counter, JobPriority priority) {
+    if (counter != nullptr) {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+    Schedule(new Job { .function = std::move(function), .pCounter = counter, .priority = priority });
+}
+
+void JobSystem::RunAfter(JobCounter &dependency, JobFunction function, JobCounter *counter, JobPriority priority) {
+    if (counter != nullptr) {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto *pJob = new Job { .function = std::move(function), .pCounter = counter, .priority = priority };
+    {
+        std::lock_guard lock(dependency._mutex);
+        if (dependency._value.load(std::memory_order_acquire) != 0) {
+            dependency._continuations.push_back(pJob);
+            return;
+        }
+    }
+    Schedule(pJob);
+}
+
+void JobSystem::RunIo(JobFunction function, JobCounter *counter) {
+    if (counter != nullptr) {
+        counter->_value.fetch_add(1, std::memory_order_relaxed);
+    }
+    Schedule(new Job { .function = std::move(function), .pCounter = counter, .io = true });
+}
+
+void JobSystem::Wait(JobCounter &counter) {
+    for (;;) {
+        const uint32_t value = counter._value.load(std::memory_order_acquire);
+        if (value == 0) {
+            break;
+        }
+        if (auto *pJob = FindJob(false)) {
+            Execute(pJob);
+            continue;
+        }
+        // 剩下的任务都已经在其他线程上执行或者还在等待依赖, 计数变化时再检查
+        counter._value.wait(value, std::memory_order_acquire);
+    }
+    // 归零的线程在持锁期间完成通知, 这里取得锁之后它不会再访问 counter, 调用方可以立即销毁 counter
+    std::lock_guard lock(counter._mutex);
+}
+
+void JobSystem::ParallelFor(size_t taskCount, const TaskFunction &task) {
+    if (taskCount == 0) {
+        return;
+    }
+    // 单个任务不值得分发
+    if (taskCount == 1) {
+        task(0, GetWorkerIndex());
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t i = 0; i < taskCount; ++i) {
+        Run([this, &task, i] { task(i, GetWorkerIndex()); }, &counter);
+    }
+    Wait(counter);
+}
+
+void JobSystem::WorkerLoop(size_t workerIndex) {
+    t_pJobSystem = this;
+    t_workerIndex = workerIndex;
+    for (;;) {
+        if (auto *pJob = FindJob(true)) {
+            Execute(pJob);
+            continue;
+        }
+
+        std::unique_lock lock(_wakeMutex);
+        _sleepingWorkers.fetch_add(1);
+        _wakeCondition.wait(lock, [this] { return _stopping || _pendingJobs.load() > 0; });
+        _sleepingWorkers.fetch_sub(1);
+        if (_stopping) {
+            return;
+        }
+    }
+}
+
+void JobSystem::IoLoop() {
+    for (;;) {
+        Job *pJob = nullptr;
+        {
+            std::unique_lock lock(_ioMutex);
+            _ioCondition.wait(lock, [this] { return _stopping || !_ioQueue.empty(); });
+            if (_stopping) {
+                return;
+            }
+            pJob = _ioQueue.front();
+            _ioQueue.pop_front();
+        }
+        Execute(pJob);
+    }
+}
+
+void JobSystem::Schedule(Job *pJob) {
+    if (pJob->io) {
+        {
+            std::lock_guard lock(_ioMutex);
+            _ioQueue.push_back(pJob);
+        }
+        _ioCondition.notify_one();
+        return;
+    }
+
+    const size_t workerIndex = GetWorkerIndex();
+    const bool local = pJob->priority == JobPriority::eHigh && workerIndex != 0 && _workers[workerIndex - 1]->deque.Push(pJob);
+    if (!local) {
+        std::lock_guard lock(_queueMutex);
+        (pJob->priority == JobPriority::eHigh ? _highQueue : _lowQueue).push_back(pJob);
+    }
+
+    // 先增加计数再检查休眠线程数, 与 WorkerLoop 中相反的顺序保证不会丢失唤醒
+    _pendingJobs.fetch_add(1);
+    if (_sleepingWorkers.load() > 0) {
+        std::lock_guard lock(_wakeMutex);
+        _wakeCondition.notify_one();
+    }
+}
+
+// 依次尝试: 自己的队列 (最新的任务, 数据还在缓存中), 全局高优先级队列, 窃取其他工作线程, 全局低优先级队列
+auto JobSystem::FindJob(bool allowLowPriority) -> Job * {
+    const size_t workerIndex = GetWorkerIndex();
+    Job *pJob = nullptr;
+    const auto take = [&]() {
+        _pendingJobs.fetch_sub(1);
+        return pJob;
+    };
+
+    if (workerIndex != 0 && _workers[workerIndex - 1]->deque.Pop(pJob)) {
+        return take();
+    }
+    {
+        std::lock_guard lock(_queueMutex);
+        if (!_highQueue.empty()) {
+            pJob = _highQueue.front();
+            _highQueue.pop_front();
+            return take();
+        }
+    }
+    // 从自己之后的线程开始窃取, 避免所有线程都先争抢同一个队列
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const size_t victim = (workerIndex + i) % _workers.size();
+        if (victim + 1 != workerIndex && _workers[victim]->deque.Steal(pJob)) {
+            return take();
+        }
+    }
+    if (allowLowPriority) {
+        std::lock_guard lock(_queueMutex);
+        if (!_lowQueue.empty()) {
+            pJob = _lowQueue.front();
+            _lowQueue.pop_front();
+            return take();
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::Execute(Job *pJob) {
+    pJob->function();
+    auto *pCounter = pJob->pCounter;
+    delete pJob;
+    Complete(pCounter);
+}
+
+void JobSystem::Complete(JobCounter *pCounter) {
+    if (pCounter == nullptr) {
+        return;
+    }
+    std::vector<Job *> continuations;
+    {
+        std::lock_guard lock(pCounter->_mutex);
+        if (pCounter->_value.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(pCounter->_continuations);
+        pCounter->_value.notify_all();
+    }
+    for (auto *pJob : continuations) {
+        Schedule(pJob);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PreprocessorDirectives.h"
+#include "WorkStealingDeque.h"
+
+class JobSystem;
+
+enum class JobPriority {
+    eHigh,      // 帧内的短任务 (命令录制等), 等待中的线程会帮忙执行
+    eLow,       // 后台长任务 (管线编译, 纹理解码), 只由空闲的工作线程执行, 不会拖慢等待帧内任务的线程
+};
+
+// 未完成的任务计数. 任务提交时加一, 执行完减一; 归零时唤醒 Wait 并调度挂在它上面的后续任务.
+// 可以在 Wait 返回后复用; 必须比计入它的任务活得更久.
+class JobCounter {
+public:
+    JobCounter() = default;
+    NON_COPYABLE(JobCounter);
+
+    auto IsDone() const -> bool { return _value.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    struct Job;
+
+private:
+    // clang-format off
+    std::atomic<uint32_t>               _value = 0;
+    std::mutex                          _mutex;                 // 保护 _continuations 和归零的过程
+    std::vector<Job *>                  _continuations;
+    // clang-format on
+};
+
+// 工作窃取的任务调度器, 运行时所有后台工作的共同基础.
+// 每个工作线程一个无锁的工作窃取队列, 工作线程提交的高优先级任务进入自己的队列, 其他线程提交的进入全局队列;
+// 低优先级任务进入单独的全局队列. 另有固定的 I/O 线程执行可能阻塞的文件读取, 不占用工作线程.
+// 等待不会阻塞工作线程: Wait 在计数归零前执行其他可运行的任务, 需要等待结果的任务应当用 RunAfter 挂为后续任务.
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+    using TaskFunction = std::function<void(size_t taskIndex, size_t workerIndex)>;
+
+    // workerThreadCount 至少为 1, 否则低优先级任务永远不会执行
+    JobSystem(size_t workerThreadCount, size_t ioThreadCount);
+    ~JobSystem();
+    NON_COPYABLE(JobSystem);
+
+    // counter 不为空时计入该任务; 可以在任意线程调用
+    void Run(JobFunction function, JobCounter *counter = nullptr, JobPriority priority = JobPriority::eHigh);
+    // dependency 归零后才调度 function; 提交时已经归零则立即调度
+    void RunAfter(JobCounter &dependency, JobFunction function, JobCounter *counter = nullptr, JobPriority priority = JobPriority::eHigh);
+    // 在 I/O 线程上执行, 按提交顺序开始; I/O 线程不止一个时任务之间可能并发, 完成顺序没有保证
+    void RunIo(JobFunction function, JobCounter *counter = nullptr);
+
+    // 计数归零前执行其他高优先级任务, 没有可执行的任务时在计数上休眠而不是自旋
+    void Wait(JobCounter &counter);
+
+    // 把 taskCount 个任务作为高优先级任务分发并等待全部完成
+    void ParallelFor(size_t taskCount, const TaskFunction &task);
+
+    // 工作线程数 + 1, 非工作线程的 workerIndex 都为 0
+    auto GetWorkerCount() const -> size_t { return _workers.size() + 1; }
+    // 按 workerIndex 划分的线程私有资源 (如命令池) 同一时刻只应被一个非工作线程使用
+    auto GetWorkerIndex() const -> size_t;
+
+private:
+    using Job = JobCounter::Job;
+
+    struct Worker {
+        std::thread thread;
+        WorkStealingDeque<Job *> deque;
+
+        explicit Worker(size_t capacity) : deque(capacity) {}
+    };
+
+private:
+    void WorkerLoop(size_t workerIndex);
+    void IoLoop();
+    void Schedule(Job *pJob);
+    auto FindJob(bool allowLowPriority) -> Job *;
+    void Execute(Job *pJob);
+    void Complete(JobCounter *pCounter);
+
+private:
+    // clang-format off
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::mutex                          _queueMutex;
+    std::deque<Job *>                   _highQueue;             // 非工作线程提交的和工作线程队列满时溢出的高优先级任务
+    std::deque<Job *>                   _lowQueue;
+
+    std::atomic<int64_t>                _pendingJobs = 0;       // 已入队还没被取走的任务数, 工作线程据此休眠
+    std::atomic<uint32_t>               _sleepingWorkers = 0;
+    std::mutex                          _wakeMutex;
+    std::condition_variable             _wakeCondition;
+
+    std::vector<std::thread>            _ioThreads;
+    std::mutex                          _ioMutex;
+    std::condition_variable             _ioCondition;
+    std::deque<Job *>                   _ioQueue;
+
+    std::atomic<bool>                   _stopping = false;
+    // clang-format on
+};
@@ -1,6 +1,9 @@
 #include "Log.h"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 
 Log::Log() : _logFilePath("app.log") {
     _logLevelMask = eInfo | eDebug | eWarning | eError;
@@ -21,9 +24,31 @@ void Log::OnCreate() {
     spdlog::set_pattern(_pattern.c_str());
     _pLogger ->set_level(spdlog::level::trace);
     _pConsoleLogger ->set_level(spdlog::level::trace);
+    _pLogger->flush_on(spdlog::level::err);
+
+    if (_async) {
+        _pRing = std::make_unique<MpscRing<LogRecord>>(_asyncCapacity);
+        _stopping = false;
+        _writtenCount = 0;
+        _droppedCount = 0;
+        _reportedDropCount = 0;
+        _backendThread = std::thread([this] { BackendLoop(); });
+    }
 }
 
 void Log::OnDestroy() {
+    if (_backendThread.joinable()) {
+        // 后台线程退出前会排空队列
+        _stopping = true;
+        _wakeup.fetch_add(1, std::memory_order_release);
+        _wakeup.notify_one();
+        _backendThread.join();
+        _pRing = nullptr;
+    }
+    if (_pLogger != nullptr) {
+        _pLogger->flush();
+        _pConsoleLogger->flush();
+    }
     _pLogger = nullptr;
     _pConsoleLogger = nullptr;
 }
@@ -52,39 +77,168 @@ auto Log::GetLogLevelMask() const -> DebugLevel {
     return _logLevelMask;
 }
 
-void Log::LogMessage(DebugLevel level, const std::source_location &location, const std::string &message) {
-    std::string stringToWrite;
-    const char *pFileName = location.file_name();
-    const uint32_t line = location.line();
-    const uint32_t column = location.column();
-    std::string output;
+void Log::SetAsync(bool enable, size_t capacity, OverflowPolicy policy) {
+    assert(_pLogger == nullptr && "SetAsync() must be called before OnCreate()");
+    _async = enable;
+    _asyncCapacity = capacity;
+    _overflowPolicy = policy;
+}
+
+auto Log::IsAsync() const -> bool {
+    return _async;
+}
+
+auto Log::GetDroppedCount() const -> uint64_t {
+    return _droppedCount.load(std::memory_order_relaxed);
+}
+
+void Log::Flush() {
+    if (_pRing != nullptr && std::this_thread::get_id() != _backendThread.get_id()) {
+        WaitUntilWritten(_pRing->GetEnqueuedCount());
+    }
+    if (_pLogger != nullptr) {
+        _pLogger->flush();
+        _pConsoleLogger->flush();
+    }
+}
+
+void Log::LogMessage(DebugLevel level, const std::source_location &location, fmt::string_view format, fmt::format_args args) {
+    if (_pLogger == nullptr) {
+        return;
+    }
+
+    const auto fillRecord = [&](LogRecord &record) {
+        record.time = spdlog::log_clock::now();
+        record.pFileName = location.file_name();
+        record.line = location.line();
+        record.column = location.column();
+        record.level = level;
+        // 异步模式下槽位已被占用, fmt::runtime() 格式串出错也必须写入一条记录, 否则消费者会卡在这个槽位
+        size_t size = 0;
+        try {
+            size = fmt::vformat_to_n(record.message, LogRecord::MESSAGE_CAPACITY, format, args).size;
+        } catch (const std::exception &e) {
+            size = fmt::format_to_n(record.message, LogRecord::MESSAGE_CAPACITY, "<format error: {}> {}", e.what(), format).size;
+        }
+        record.length = static_cast<uint32_t>(std::min(size, LogRecord::MESSAGE_CAPACITY));
+        if (size > LogRecord::MESSAGE_CAPACITY) {
+            std::memcpy(record.message + LogRecord::MESSAGE_CAPACITY - 3, "...", 3);
+        }
+    };
+
+    // 同步模式不经过定长槽位, 正文不截断
+    if (!_async) {
+        fmt::memory_buffer message;
+        fmt::vformat_to(std::back_inserter(message), format, args);
+        WriteMessage(spdlog::log_clock::now(), location.file_name(), location.line(), location.column(), level,
+                     std::string_view(message.data(), message.size()));
+        return;
+    }
+
+    // 后台线程自身 (例如日志回调中) 写日志时不能阻塞等待自己
+    const bool onBackend = std::this_thread::get_id() == _backendThread.get_id();
+    uint64_t ticket = 0;
+    while (!_pRing->TryPush(fillRecord, ticket)) {
+        if (_overflowPolicy == OverflowPolicy::eDrop || onBackend) {
+            _droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    // 与 BackendLoop 中的 fence 配对: 要么后台线程看到新记录, 要么这里看到它在等待并唤醒它
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_backendWaiting.load(std::memory_order_relaxed)) {
+        _wakeup.fetch_add(1, std::memory_order_release);
+        _wakeup.notify_one();
+    }
+
+    // 错误之后往往紧跟异常或崩溃, 等它落盘再返回
+    if (level == eError && !onBackend) {
+        WaitUntilWritten(ticket + 1);
+    }
+}
+
+void Log::WriteRecord(const LogRecord &record) {
+    WriteMessage(record.time, record.pFileName, record.line, record.column, record.level, std::string_view(record.message, record.length));
+}
+
+void Log::WriteMessage(spdlog::log_clock::time_point time, const char *pFileName, uint32_t line, uint32_t column, DebugLevel level,
+                       std::string_view message) {
+    const char *pTag = nullptr;
+    spdlog::level::level_enum spdLevel = spdlog::level::off;
     switch (level) {
     case eInfo:
-        output = fmt::format("{}({},{}) [info ]: {}", pFileName, line, column, message);
-        _pLogger->info("{}", output);
-        _pConsoleLogger->info("{}", output);
+        pTag = "info ";
+        spdLevel = spdlog::level::info;
         break;
     case eDebug:
-        output = fmt::format("{}({},{}) [Debug]: {}", pFileName, line, column, message);
-        _pLogger->debug("{}", output);
-        _pConsoleLogger->debug("{}", output);
+        pTag = "Debug";
+        spdLevel = spdlog::level::debug;
         break;
     case eWarning:
-        output = fmt::format("{}({},{}) [Warn ]: {}", pFileName, line, column, message);
-        _pLogger->warn("{}", output);
-        _pConsoleLogger->warn("{}", output);
+        pTag = "Warn ";
+        spdLevel = spdlog::level::warn;
         break;
     case eError:
-        output = fmt::format("{}({},{}) [Error]: {}", pFileName, line, column, message);
-        _pLogger->error("{}", output);
-        _pConsoleLogger->error("{}", output);
+        pTag = "Error";
+        spdLevel = spdlog::level::err;
         break;
     case eNone:
     default:
         return;
     }
 
+    fmt::memory_buffer output;
+    fmt::format_to(std::back_inserter(output), "{}({},{}) [{}]: {}", pFileName, line, column, pTag, message);
+    const spdlog::string_view_t text(output.data(), output.size());
+    _pLogger->log(time, spdlog::source_loc{}, spdLevel, text);
+    _pConsoleLogger->log(time, spdlog::source_loc{}, spdLevel, text);
+
     if (_logCallback != nullptr) {
-        _logCallback(level, output);
+        _logCallback(level, fmt::to_string(output));
+    }
+}
+
+void Log::BackendLoop() {
+    for (;;) {
+        const uint32_t wakeup = _wakeup.load(std::memory_order_acquire);
+        while (_pRing->TryPop([this](const LogRecord &record) { WriteRecord(record); })) {
+            _writtenCount.fetch_add(1, std::memory_order_release);
+        }
+
+        const uint64_t dropCount = _droppedCount.load(std::memory_order_relaxed);
+        if (dropCount != _reportedDropCount) {
+            LogRecord record;
+            record.time = spdlog::log_clock::now();
+            record.pFileName = __FILE__;
+            record.line = __LINE__;
+            record.column = 0;
+            record.level = eWarning;
+            record.length = static_cast<uint32_t>(fmt::format_to_n(record.message, LogRecord::MESSAGE_CAPACITY,
+                "{} log records dropped, ring buffer full", dropCount - _reportedDropCount).size);
+            WriteRecord(record);
+            _reportedDropCount = dropCount;
+        }
+
+        if (_stopping.load(std::memory_order_acquire)) {
+            if (!_pRing->IsReadable()) {
+                break;
+            }
+            continue;
+        }
+
+        _backendWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!_pRing->IsReadable() && !_stopping.load(std::memory_order_acquire)) {
+            _wakeup.wait(wakeup, std::memory_order_acquire);
+        }
+        _backendWaiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Log::WaitUntilWritten(uint64_t count) {
+    while (_writtenCount.load(std::memory_order_acquire) < count) {
+        std::this_thread::yield();
     }
 }
@@ -4,27 +4,45 @@
 #include <string_view>
 #include <source_location>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <type_traits>
 #include "PreprocessorDirectives.h"
+#include "MpscRing.h"
 
+// 格式串在编译期按参数类型校验 (fmt::format_string), 运行时拼出的格式串需显式包一层 fmt::runtime()
+template<typename... Args>
 struct FormatAndLocation {
-    std::string_view fmt;
+    fmt::format_string<Args...> fmt;
     std::source_location location;
 public:
-    template<size_t N>
-    FormatAndLocation(const char (&arr)[N], const std::source_location &l = std::source_location::current())
-        : fmt(arr), location(l) {
-    }
-    FormatAndLocation(const std::string_view &fmt, const std::source_location &l = std::source_location::current())
-        : fmt(fmt), location(l) {
+    template<typename S>
+        requires std::is_convertible_v<const S &, fmt::string_view>
+    consteval FormatAndLocation(const S &s, const std::source_location &l = std::source_location::current())
+        : fmt(s), location(l) {
     }
-    FormatAndLocation(const std::string &fmt, const std::source_location &l = std::source_location::current())
-        : fmt(fmt.c_str(), fmt.length()), location(l) {
-    }
-    FormatAndLocation(const char *cString, const std::source_location &l = std::source_location::current())
-        : fmt(cString, (cString != nullptr ? strlen(cString) : 0)), location(l) {
+    FormatAndLocation(fmt::basic_runtime<char> runtimeFmt, const std::source_location &l = std::source_location::current())
+        : fmt(runtimeFmt), location(l) {
     }
 };
 
+// 编译期保留的日志级别, 其余级别的调用在编译期被整体剔除. 可在编译选项中预先定义以覆盖
+#ifndef LOG_COMPILED_LEVEL_MASK
+    #if defined(MODE_RELEASE)
+        #define LOG_COMPILED_LEVEL_MASK (Log::eWarning | Log::eError)
+    #elif defined(MODE_RELWITHDEBINFO)
+        #define LOG_COMPILED_LEVEL_MASK (Log::eInfo | Log::eWarning | Log::eError)
+    #else
+        #define LOG_COMPILED_LEVEL_MASK (Log::eAll)
+    #endif
+#endif
+
+// 参数本身有求值开销时使用宏版本: 级别被剔除时参数表达式也不会求值
+#define LOG_INFO(...)    do { if constexpr (Log::IsLevelCompiled(Log::eInfo)) { Log::Info(__VA_ARGS__); } } while (0)
+#define LOG_DEBUG(...)   do { if constexpr (Log::IsLevelCompiled(Log::eDebug)) { Log::Debug(__VA_ARGS__); } } while (0)
+#define LOG_WARNING(...) do { if constexpr (Log::IsLevelCompiled(Log::eWarning)) { Log::Warning(__VA_ARGS__); } } while (0)
+#define LOG_ERROR(...)   do { if constexpr (Log::IsLevelCompiled(Log::eError)) { Log::Error(__VA_ARGS__); } } while (0)
+
 class Log {
 public:
     enum DebugLevel {
@@ -39,6 +57,12 @@ public:
     };
     ENUM_FLAGS_AS_MEMBER(DebugLevel)
     using LogCallBack = std::function<void(DebugLevel, const std::string &)>;
+
+    // 异步模式下环形队列写满时的处理方式
+    enum class OverflowPolicy {
+        eDrop,      // 丢弃并计数, 调用线程永不阻塞
+        eBlock,     // 自旋让出直到后台线程腾出槽位
+    };
 public:
     Log();
     ~Log();
@@ -57,92 +81,153 @@ public:
     void SetLogPath(const std::filesystem::path &path);
     auto GetLogPath() const -> std::filesystem::path;
 
+    // 需在 OnCreate 之前调用. 异步模式下调用线程只格式化正文并写入无锁队列, 前缀格式化,
+    // sink I/O 和日志回调都在后台线程执行
+    void SetAsync(bool enable, size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::eDrop);
+    auto IsAsync() const -> bool;
+    auto GetDroppedCount() const -> uint64_t;
+
+    static constexpr auto IsLevelCompiled(DebugLevel level) -> bool {
+        return (static_cast<uint32_t>(LOG_COMPILED_LEVEL_MASK) & static_cast<uint32_t>(level)) != 0;
+    }
+    // 等待此前写入队列的记录全部落盘
+    void Flush();
+
     template<typename... Args>
-    static void Info(FormatAndLocation fmtAndLoc, Args &&...args);
+    static void Info(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args);
 
     template<typename... Args>
-    static void Debug(FormatAndLocation fmtAndLoc, Args &&...args);
+    static void Debug(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args);
 
     template<typename... Args>
-    static void Warning(FormatAndLocation fmtAndLoc, Args &&...args);
+    static void Warning(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args);
 
     template<typename... Args>
-    static void Error(FormatAndLocation fmtAndLoc, Args &&...args);
+    static void Error(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args);
 
 
     template<typename... Args>
-    static void InfoIf(bool cond, FormatAndLocation fmtAndLoc, Args &&...args) {
-	    if (cond) {
-		    Info(fmtAndLoc, std::forward<Args>(args)...);
+    static void InfoIf(bool cond, FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+	    if constexpr (IsLevelCompiled(eInfo)) {
+		    if (cond) {
+			    Info(fmtAndLoc, std::forward<Args>(args)...);
+		    }
 	    }
     }
 
 	template<typename... Args>
-	static void DebugIf(bool cond, FormatAndLocation fmtAndLoc, Args &&...args) {
-	    if (cond) {
-		    Debug(fmtAndLoc, std::forward<Args>(args)...);
+	static void DebugIf(bool cond, FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+	    if constexpr (IsLevelCompiled(eDebug)) {
+		    if (cond) {
+			    Debug(fmtAndLoc, std::forward<Args>(args)...);
+		    }
 	    }
 	}
 
 	template<typename... Args>
-	static void WarningIf(bool cond, FormatAndLocation fmtAndLoc, Args &&...args) {
-	    if (cond) {
-		    Warning(fmtAndLoc, std::forward<Args>(args)...);
+	static void WarningIf(bool cond, FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+	    if constexpr (IsLevelCompiled(eWarning)) {
+		    if (cond) {
+			    Warning(fmtAndLoc, std::forward<Args>(args)...);
+		    }
 	    }
 	}
 
 	template<typename... Args>
-	static void ErrorIf(bool cond, FormatAndLocation fmtAndLoc, Args &&...args) {
-	    if (cond) {
-		    Error(fmtAndLoc, std::forward<Args>(args)...);
+	static void ErrorIf(bool cond, FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+	    if constexpr (IsLevelCompiled(eError)) {
+		    if (cond) {
+			    Error(fmtAndLoc, std::forward<Args>(args)...);
+		    }
 	    }
 	}
 private:
-    void LogMessage(DebugLevel level, const std::source_location &location, const std::string &message);
+    // 异步模式的定长日志记录, 正文在调用线程格式化一次, 超长部分截断
+    struct LogRecord {
+        static constexpr size_t MESSAGE_CAPACITY = 984;    // 加上队列槽位序号正好 1 KB
+
+        // clang-format off
+        spdlog::log_clock::time_point   time;
+        const char                     *pFileName;
+        uint32_t                        line;
+        uint32_t                        column;
+        DebugLevel                      level;
+        uint32_t                        length;
+        char                            message[MESSAGE_CAPACITY];
+        // clang-format on
+    };
+
+private:
+    void LogMessage(DebugLevel level, const std::source_location &location, fmt::string_view format, fmt::format_args args);
+    void WriteRecord(const LogRecord &record);
+    void WriteMessage(spdlog::log_clock::time_point time, const char *pFileName, uint32_t line, uint32_t column, DebugLevel level,
+                      std::string_view message);
+    void BackendLoop();
+    void WaitUntilWritten(uint64_t count);
 private:
     // clang-format off
-    DebugLevel                          _logLevelMask = eAll;
-    std::string                         _pattern;
-    std::string                         _logFilePath;
-    LogCallBack                         _logCallback;
-    std::shared_ptr<spdlog::logger>     _pLogger;
-    std::shared_ptr<spdlog::logger>     _pConsoleLogger;
+    DebugLevel                              _logLevelMask = eAll;
+    std::string                             _pattern;
+    std::string                             _logFilePath;
+    LogCallBack                             _logCallback;
+    std::shared_ptr<spdlog::logger>         _pLogger;
+    std::shared_ptr<spdlog::logger>         _pConsoleLogger;
+
+    bool                                    _async = false;
+    size_t                                  _asyncCapacity = 4096;
+    OverflowPolicy                          _overflowPolicy = OverflowPolicy::eDrop;
+    std::unique_ptr<MpscRing<LogRecord>>    _pRing;
+    std::thread                             _backendThread;
+    std::atomic<bool>                       _stopping = false;
+    std::atomic<bool>                       _backendWaiting = false;
+    std::atomic<uint32_t>                   _wakeup = 0;
+    std::atomic<uint64_t>                   _writtenCount = 0;
+    std::atomic<uint64_t>                   _droppedCount = 0;
+    uint64_t                                _reportedDropCount = 0;
     // clang-format on
 };
 
 
 template<typename... Args>
-void Log::Info(FormatAndLocation fmtAndLoc, Args &&...args) {
-    if (GetInstance() == nullptr || !HasFlag(GetInstance()->GetLogLevelMask(), eInfo)) {
-        return;
+void Log::Info(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+    if constexpr (IsLevelCompiled(eInfo)) {
+        Log *pLog = GetInstance();
+        if (pLog == nullptr || !HasFlag(pLog->GetLogLevelMask(), eInfo)) {
+            return;
+        }
+        pLog->LogMessage(eInfo, fmtAndLoc.location, fmtAndLoc.fmt, fmt::make_format_args(args...));
     }
-    std::string message = fmt::vformat(fmtAndLoc.fmt, fmt::make_format_args(std::forward<Args>(args)...));
-    GetInstance()->LogMessage(eInfo, fmtAndLoc.location, message);
 }
 
 template<typename... Args>
-void Log::Debug(FormatAndLocation fmtAndLoc, Args &&...args) {
-    if (GetInstance() == nullptr || !HasFlag(GetInstance()->GetLogLevelMask(), eDebug)) {
-        return;
+void Log::Debug(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+    if constexpr (IsLevelCompiled(eDebug)) {
+        Log *pLog = GetInstance();
+        if (pLog == nullptr || !HasFlag(pLog->GetLogLevelMask(), eDebug)) {
+            return;
+        }
+        pLog->LogMessage(eDebug, fmtAndLoc.location, fmtAndLoc.fmt, fmt::make_format_args(args...));
     }
-    std::string message = fmt::vformat(fmtAndLoc.fmt, fmt::make_format_args(std::forward<Args>(args)...));
-    GetInstance()->LogMessage(eDebug, fmtAndLoc.location, message);
 }
 
 template<typename... Args>
-void Log::Warning(FormatAndLocation fmtAndLoc, Args &&...args) {
-    if (GetInstance() == nullptr || !HasFlag(GetInstance()->GetLogLevelMask(), eWarning)) {
-        return;
+void Log::Warning(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+    if constexpr (IsLevelCompiled(eWarning)) {
+        Log *pLog = GetInstance();
+        if (pLog == nullptr || !HasFlag(pLog->GetLogLevelMask(), eWarning)) {
+            return;
+        }
+        pLog->LogMessage(eWarning, fmtAndLoc.location, fmtAndLoc.fmt, fmt::make_format_args(args...));
     }
-    std::string message = fmt::vformat(fmtAndLoc.fmt, fmt::make_format_args(std::forward<Args>(args)...));
-    GetInstance()->LogMessage(eWarning, fmtAndLoc.location, message);
 }
 
 template<typename... Args>
-void Log::Error(FormatAndLocation fmtAndLoc, Args &&...args) {
-    if (GetInstance() == nullptr || !HasFlag(GetInstance()->GetLogLevelMask(), eError)) {
-        return;
+void Log::Error(FormatAndLocation<std::type_identity_t<Args>...> fmtAndLoc, Args &&...args) {
+    if constexpr (IsLevelCompiled(eError)) {
+        Log *pLog = GetInstance();
+        if (pLog == nullptr || !HasFlag(pLog->GetLogLevelMask(), eError)) {
+            return;
+        }
+        pLog->LogMessage(eError, fmtAndLoc.location, fmtAndLoc.fmt, fmt::make_format_args(args...));
     }
-    std::string message = fmt::vformat(fmtAndLoc.fmt, fmt::make_format_args(std::forward<Args>(args)...));
-    GetInstance()->LogMessage(eError, fmtAndLoc.location, message);
 }
\ No newline at end of file
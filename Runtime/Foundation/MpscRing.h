@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include "PreprocessorDirectives.h"
+
+// 有界多生产者单消费者环形队列 (Vyukov), 每个槽位带序号, 生产者之间只竞争一次 CAS, 全程无锁.
+// 写入和读取都通过回调直接作用在槽位上, 大对象不需要额外拷贝.
+template<typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity);
+    NON_COPYABLE(MpscRing);
+
+    // 队列已满时返回 false; 成功时 ticket 为该元素的全局序号, 消费者按序号顺序取出
+    template<typename Writer>
+    bool TryPush(Writer &&writer, uint64_t &ticket);
+
+    // 只能由唯一的消费者线程调用
+    template<typename Reader>
+    bool TryPop(Reader &&reader);
+    auto IsReadable() const -> bool;
+
+    auto GetCapacity() const -> size_t { return _mask + 1; }
+    // 已被生产者占用的槽位总数 (含尚未写完的)
+    auto GetEnqueuedCount() const -> uint64_t { return _enqueuePos.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        T                     data;
+    };
+
+private:
+    // clang-format off
+    std::unique_ptr<Cell[]>             _cells;
+    size_t                              _mask = 0;
+    alignas(64) std::atomic<uint64_t>   _enqueuePos = 0;
+    alignas(64) uint64_t                _dequeuePos = 0;
+    // clang-format on
+};
+
+template<typename T>
+MpscRing<T>::MpscRing(size_t capacity) {
+    capacity = std::bit_ceil(capacity < 2 ? size_t(2) : capacity);
+    _cells = std::make_unique<Cell[]>(capacity);
+    _mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+template<typename Writer>
+bool MpscRing<T>::TryPush(Writer &&writer, uint64_t &ticket) {
+    uint64_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    Cell *pCell = nullptr;
+    for (;;) {
+        pCell = &_cells[pos & _mask];
+        const uint64_t sequence = pCell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位还没被消费者释放: 队列已满
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    writer(pCell->data);
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+    ticket = pos;
+    return true;
+}
+
+template<typename T>
+template<typename Reader>
+bool MpscRing<T>::TryPop(Reader &&reader) {
+    Cell &cell = _cells[_dequeuePos & _mask];
+    const uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<int64_t>(sequence) - static_cast<int64_t>(_dequeuePos + 1) < 0) {
+        return false;
+    }
+
+    reader(cell.data);
+    cell.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+    ++_dequeuePos;
+    return true;
+}
+
+template<typename T>
+auto MpscRing<T>::IsReadable() const -> bool {
+    const Cell &cell = _cells[_dequeuePos & _mask];
+    return cell.sequence.load(std::memory_order_acquire) == _dequeuePos + 1;
+}
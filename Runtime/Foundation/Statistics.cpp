@@ -0,0 +1,85 @@
+#include "Statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+auto ComputePercentile(std::span<const double> samples, double percentile) -> double {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted(samples.begin(), samples.end());
+    const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+    const auto index = std::clamp<size_t>(rank, 1, sorted.size()) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+auto Summarize(std::span<const double> samples) -> StatisticsSummary {
+    StatisticsSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::vector<double> sorted(samples.begin(), samples.end());
+    std::sort(sorted.begin(), sorted.end());
+    const auto at = [&](double percentile) {
+        const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    };
+
+    summary.count = sorted.size();
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+    summary.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+    summary.p50 = at(50.0);
+    summary.p95 = at(95.0);
+    summary.p99 = at(99.0);
+    return summary;
+}
+
+RollingStatistics::RollingStatistics(size_t capacity) : _capacity(std::max<size_t>(capacity, 1)) {
+    _samples.reserve(_capacity);
+}
+
+void RollingStatistics::AddSample(double value) {
+    if (_samples.size() < _capacity) {
+        _samples.push_back(value);
+    } else {
+        _samples[_next] = value;
+    }
+    _next = (_next + 1) % _capacity;
+    _latest = value;
+}
+
+void RollingStatistics::Reset() {
+    _samples.clear();
+    _next = 0;
+    _latest = 0.0;
+}
+
+auto RollingStatistics::GetCount() const -> size_t {
+    return _samples.size();
+}
+
+auto RollingStatistics::GetLatest() const -> double {
+    return _latest;
+}
+
+auto RollingStatistics::GetMean() const -> double {
+    if (_samples.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(_samples.begin(), _samples.end(), 0.0) / static_cast<double>(_samples.size());
+}
+
+auto RollingStatistics::GetPercentile(double percentile) const -> double {
+    return ComputePercentile(getSamples(), percentile);
+}
+
+auto RollingStatistics::GetSummary() const -> StatisticsSummary {
+    return Summarize(getSamples());
+}
+
+auto RollingStatistics::getSamples() const -> std::span<const double> {
+    return {_samples.data(), _samples.size()};
+}
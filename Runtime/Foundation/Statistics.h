@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+
+struct StatisticsSummary {
+    size_t count = 0;
+    double min = 0.0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Nearest-rank percentile, percentile in [0, 100]. Sorts a copy of samples.
+auto ComputePercentile(std::span<const double> samples, double percentile) -> double;
+auto Summarize(std::span<const double> samples) -> StatisticsSummary;
+
+class RollingStatistics {
+public:
+    explicit RollingStatistics(size_t capacity = 256);
+
+    void AddSample(double value);
+    void Reset();
+
+    auto GetCount() const -> size_t;
+    auto GetLatest() const -> double;
+    auto GetMean() const -> double;
+    auto GetPercentile(double percentile) const -> double;
+    auto GetSummary() const -> StatisticsSummary;
+private:
+    auto getSamples() const -> std::span<const double>;
+private:
+    // clang-format off
+    std::vector<double>                 _samples;
+    size_t                              _capacity = 0;
+    size_t                              _next = 0;
+    double                              _latest = 0.0;
+    // clang-format on
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include "PreprocessorDirectives.h"
+
+// 单生产者单消费者的三缓冲快照: 生产者写一个槽位, 消费者读一个槽位, 第三个槽位存放已发布还没被取走的快照.
+// 生产者最多领先消费者一个快照, 已发布的快照不会被覆盖或丢弃; 槽位循环复用, 其中的容器保留已分配的内存.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    NON_COPYABLE(TripleBuffer);
+
+    // 生产者独占的槽位, 内容是三个快照之前写入的, 调用方负责覆盖
+    auto GetWriteSlot() -> T & { return _slots[_writeIndex]; }
+
+    // 消费者还没取走上一个快照时阻塞; 关闭后返回 false
+    bool Publish();
+
+    // 阻塞到有新快照; 返回的快照在下一次 Acquire 之前有效. 关闭且没有剩余快照时返回空指针
+    auto Acquire() -> const T *;
+
+    // 唤醒双方, 已发布的最后一个快照仍然可以被取走
+    void Close();
+
+private:
+    // clang-format off
+    std::array<T, 3>                    _slots {};
+    uint32_t                            _writeIndex = 0;
+    uint32_t                            _readyIndex = 1;
+    uint32_t                            _readIndex = 2;
+    bool                                _hasReady = false;
+    bool                                _closed = false;
+    std::mutex                          _mutex;
+    std::condition_variable             _condition;
+    // clang-format on
+};
+
+template<typename T>
+bool TripleBuffer<T>::Publish() {
+    {
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return !_hasReady || _closed; });
+        if (_closed) {
+            return false;
+        }
+        std::swap(_writeIndex, _readyIndex);
+        _hasReady = true;
+    }
+    _condition.notify_all();
+    return true;
+}
+
+template<typename T>
+auto TripleBuffer<T>::Acquire() -> const T * {
+    {
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return _hasReady || _closed; });
+        if (!_hasReady) {
+            return nullptr;
+        }
+        std::swap(_readIndex, _readyIndex);
+        _hasReady = false;
+    }
+    _condition.notify_all();
+    return &_slots[_readIndex];
+}
+
+template<typename T>
+void TripleBuffer<T>::Close() {
+    {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+    }
+    _condition.notify_all();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include "PreprocessorDirectives.h"
+
+// 有界 Chase-Lev 工作窃取双端队列 (按 Lê 等人的 C11 内存序版本). 所属线程在底部 Push/Pop (LIFO, 缓存友好),
+// 其他线程从顶部 Steal (FIFO, 先拿到较早、通常较大的任务). 全程无锁, 只有争抢最后一个元素时才需要 CAS.
+// T 需要可以平凡复制, 通常是指针.
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    explicit WorkStealingDeque(size_t capacity);
+    NON_COPYABLE(WorkStealingDeque);
+
+    // 只能由所属线程调用; 队列已满时返回 false, 由调用方另行安排
+    bool Push(T item);
+    bool Pop(T &item);
+
+    // 任意线程调用; 与其他线程争抢失败时也返回 false
+    bool Steal(T &item);
+
+    auto IsEmpty() const -> bool;
+
+private:
+    // clang-format off
+    std::unique_ptr<std::atomic<T>[]>   _items;
+    int64_t                             _mask = 0;
+    alignas(64) std::atomic<int64_t>    _top = 0;
+    alignas(64) std::atomic<int64_t>    _bottom = 0;
+    // clang-format on
+};
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) {
+    capacity = std::bit_ceil(capacity < 2 ? size_t(2) : capacity);
+    _items = std::make_unique<std::atomic<T>[]>(capacity);
+    _mask = static_cast<int64_t>(capacity) - 1;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::Push(T item) {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    const int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top > _mask) {
+        return false;
+    }
+    _items[bottom & _mask].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::Pop(T &item) {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // 队列为空, 恢复 bottom
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+    item = _items[bottom & _mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // 最后一个元素, 与窃取方竞争
+        const bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::Steal(T &item) {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return false;
+    }
+    item = _items[top & _mask].load(std::memory_order_relaxed);
+    return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+template<typename T>
+auto WorkStealingDeque<T>::IsEmpty() const -> bool {
+    return _top.load(std::memory_order_acquire) >= _bottom.load(std::memory_order_acquire);
+}
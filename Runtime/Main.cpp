@@ -2,10 +2,16 @@
 #include "Foundation/Log.h"
 
 int main(int argc, char **argv) {
-    //Log::GetInstance()->OnCreate();
+    // 校验层回调和逐帧日志不在渲染线程上做 I/O
+    Log::GetInstance()->SetAsync(true);
+    Log::GetInstance()->OnCreate();
 
-    Application app;
-    app.run();
+    int exitCode = 0;
+    {
+        Application app(Application::ParseCommandLine(argc, argv));
+        exitCode = app.run();
+    }
 
-    //Log::GetInstance()->OnDestroy();
+    Log::GetInstance()->OnDestroy();
+    return exitCode;
 }
\ No newline at end of file
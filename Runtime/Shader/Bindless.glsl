@@ -0,0 +1,10 @@
+// 与 Core/BindlessHeap 对应的全局描述符集, 着色器用推送常量中的下标访问资源
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 0, binding = 0) uniform texture2D bindlessTextures[];
+layout(set = 0, binding = 1) uniform sampler bindlessSamplers[];
+layout(set = 0, binding = 2, std430) readonly buffer BindlessStorageBuffer { uint data[]; } bindlessBuffers[];
+
+// 下标可能在同一个 subgroup 内不一致时 (例如来自逐实例数据) 需要 nonuniformEXT
+#define BINDLESS_SAMPLE(textureIndex, samplerIndex, uv) \
+    texture(sampler2D(bindlessTextures[nonuniformEXT(textureIndex)], bindlessSamplers[nonuniformEXT(samplerIndex)]), uv)
@@ -1,20 +1,25 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
-vec2 positions[3] = vec2[](
-vec2(0.0, -0.5),
-vec2(0.5, 0.5),
-vec2(-0.5, 0.5)
-);
+// 与 Core/StressScene.h 中的 InstanceData 一致
+struct InstanceData {
+    vec4 positionScale;
+    vec4 color;
+};
+
+layout(set = 0, binding = 2, std430) readonly buffer InstanceBuffer { InstanceData instances[]; } instanceBuffers[];
 
-vec3 colors[3] = vec3[](
-vec3(1.0, 0.0, 0.0),
-vec3(0.0, 1.0, 0.0),
-vec3(0.0, 0.0, 1.0)
-);
+layout(push_constant) uniform PushConstants {
+    uint instanceBuffer;
+} pc;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
-}
\ No newline at end of file
+    InstanceData instance = instanceBuffers[pc.instanceBuffer].instances[gl_InstanceIndex];
+    gl_Position = vec4(inPosition * instance.positionScale.w + instance.positionScale.xyz, 1.0);
+    fragColor = inColor * instance.color.rgb;
+}
@@ -0,0 +1,73 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/core.h>
+#include "Foundation/AssetPack.h"
+
+// 用法: AssetPacker <output.pak> [--lz4 | --no-compress] [--root <dir>] <files...>
+// 条目名为相对于 --root 的路径 ('/' 分隔), 没有 --root 时为文件名; 压缩选项作用于其后的文件
+namespace {
+
+auto ReadBinaryFile(const std::filesystem::path &path, std::vector<std::byte> &data) -> bool {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+auto MakeEntryName(const std::filesystem::path &file, const std::filesystem::path &root) -> std::string {
+    if (root.empty()) {
+        return file.filename().generic_string();
+    }
+    return std::filesystem::relative(file, root).generic_string();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fmt::print(stderr, "Usage: {} <output.pak> [--lz4 | --no-compress] [--root <dir>] <files...>\n", argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path output = argv[1];
+    std::filesystem::path root;
+    auto compression = AssetCompression::eNone;
+    AssetPackWriter writer;
+    uint64_t inputBytes = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--lz4") {
+            compression = AssetCompression::eLz4;
+        } else if (arg == "--no-compress") {
+            compression = AssetCompression::eNone;
+        } else if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else {
+            const std::filesystem::path file = argv[i];
+            std::vector<std::byte> data;
+            if (!ReadBinaryFile(file, data)) {
+                fmt::print(stderr, "Failed to read {}\n", file.string());
+                return 1;
+            }
+            inputBytes += data.size();
+            writer.Add(MakeEntryName(file, root), std::move(data), compression);
+        }
+    }
+
+    std::string error;
+    if (!writer.Write(output, error)) {
+        fmt::print(stderr, "Failed to write {}: {}\n", output.string(), error);
+        return 1;
+    }
+    fmt::print("Packed {} files ({} bytes) into {} ({} bytes)\n", writer.GetEntryCount(), inputBytes, output.string(),
+               std::filesystem::file_size(output));
+    return 0;
+}
@@ -1,3 +1,5 @@
-C:\VulkanSDK\1.3.280.0\Bin\glslangValidator.exe -V src/shader/shader.vert
-C:\VulkanSDK\1.3.280.0\Bin\glslangValidator.exe -V src/shader/shader.frag
+C:\VulkanSDK\1.3.280.0\Bin\glslangValidator.exe -V Runtime/Shader/shader.vert
+C:\VulkanSDK\1.3.280.0\Bin\glslangValidator.exe -V Runtime/Shader/shader.frag
+C:\VulkanSDK\1.3.280.0\Bin\glslangValidator.exe -V Runtime/Shader/cull.comp -o cull.spv
+if exist Bin\AssetPacker.exe Bin\AssetPacker.exe assets.pak vert.spv frag.spv cull.spv
 pause
\ No newline at end of file
@@ -29,15 +29,32 @@ add_requires("spdlog v1.9.2")
 add_requires("glfw 3.3.8")               
 add_requires("vulkan-memory-allocator v3.0.1")
 add_requires("magic_enum v0.9.0")
-add_requires("vulkansdk", {system = true})
+add_requires("vulkansdk", {system = true, configs = {utils = {"shaderc_shared"}}})    -- shaderc: 着色器热重载时在运行时编译 GLSL
 add_requires("glm")
 add_requires("stb 2023.01.30")
+add_requires("lz4 v1.9.4")                                                          -- 资源包条目的可选压缩
 -- add_requires("imgui v1.89.7-docking", {debug = isDebug})      
 -- add_requires("vulkan-hpp v1.3.250", {verify = false})        
 -- add_requires("stduuid", {debug = isDebug})
 -- add_requires("jsoncpp 1.9.5", {debug = isDebug, configs = {shared = false}})
 
 
+-- 构建时把 GLSL 编译为 SPIR-V, 输出到项目根目录 (运行时从 Bin 的上一级读取); 输出文件名由 add_files 的 spv 配置指定
+rule("glsl2spv")
+    set_extensions(".vert", ".frag", ".comp")
+    on_buildcmd_file(function (target, batchcmds, sourcefile, opt)
+        import("lib.detect.find_tool")
+        local sdkdir = os.getenv("VULKAN_SDK")
+        local glslang = assert(find_tool("glslangValidator", {paths = sdkdir and path.join(sdkdir, "Bin")}), "glslangValidator not found, install the Vulkan SDK")
+        local outputfile = path.join(os.projectdir(), target:fileconfig(sourcefile).spv)
+        batchcmds:show_progress(opt.progress, "${color.build.object}compiling.glsl %s", sourcefile)
+        batchcmds:vrunv(glslang.program, {"-V", "-o", outputfile, sourcefile})
+        batchcmds:add_depfiles(sourcefile)
+        batchcmds:set_depmtime(os.mtime(outputfile))
+        batchcmds:set_depcache(target:dependfile(outputfile))
+    end)
+rule_end()
+
 target("VitalVision")
     set_languages("c++latest")
     set_warnings("all")
@@ -48,6 +65,11 @@ target("VitalVision")
     add_headerfiles("Runtime/**.inc")
     add_files("Runtime/**.cpp")
     add_includedirs(RUNTIME_DIR)
+
+    add_rules("glsl2spv")
+    add_files("Runtime/Shader/shader.vert", {spv = "vert.spv"})
+    add_files("Runtime/Shader/shader.frag", {spv = "frag.spv"})
+    add_files("Runtime/Shader/cull.comp", {spv = "cull.spv"})
     
     add_defines("PLATFORM_WIN")
     add_defines("VULKAN_HPP_DISPATCH_LOADER_DYNAMIC=1")
@@ -63,6 +85,7 @@ target("VitalVision")
     add_packages("magic_enum")
     add_packages("glm")
     add_packages("stb")
+    add_packages("lz4")
     -- add_packages("imgui")
     -- add_packages("vulkan-hpp")
     -- add_packages("jsoncpp")
@@ -75,4 +98,33 @@ target("VitalVision")
 
     set_targetdir(BINARY_DIR)
     add_syslinks("Advapi32")
-target_end()
\ No newline at end of file
+
+    -- 资源包优先于散文件: 着色器重新编译后要重新打包, 否则运行的仍是包里旧的 SPIR-V, 与当前的顶点输入和推送常量不一致
+    add_deps("AssetPacker")
+    after_build(function (target)
+        local shaders = {}
+        for _, sourcefile in ipairs(target:sourcefiles()) do
+            local fileconfig = target:fileconfig(sourcefile)
+            if fileconfig and fileconfig.spv then
+                table.insert(shaders, fileconfig.spv)
+            end
+        end
+        os.vrunv(target:dep("AssetPacker"):targetfile(), table.join({"assets.pak"}, shaders), {curdir = os.projectdir()})
+    end)
+target_end()
+
+-- 离线打包工具: 把 .spv 等文件打成运行时 mmap 的资源包
+target("AssetPacker")
+    set_languages("c++latest")
+    set_warnings("all")
+    set_kind("binary")
+
+    add_files("Tools/AssetPacker/*.cpp")
+    add_files("Runtime/Foundation/AssetPack.cpp")
+    add_includedirs(RUNTIME_DIR)
+
+    add_packages("fmt")
+    add_packages("lz4")
+
+    set_targetdir(BINARY_DIR)
+target_end()